@@ -0,0 +1,51 @@
+"""Compare parsing a large config with loading its compiled snapshot.
+
+    uv run python benchmarks/bench_compiled.py
+"""
+
+import os
+import tempfile
+import time
+
+import hyprlang_pybind as hyprlang
+
+LINES = 10_000
+RUNS = 20
+
+
+def best(fn) -> float:
+    result = float("inf")
+    for _ in range(RUNS):
+        t = time.perf_counter()
+        fn()
+        result = min(result, time.perf_counter() - t)
+    return result
+
+
+def main() -> None:
+    with tempfile.TemporaryDirectory() as tmp:
+        conf = os.path.join(tmp, "big.conf")
+        snap = os.path.join(tmp, "big.bin")
+        with open(conf, "w") as f:
+            for i in range(LINES):
+                f.write(f"cat{i % 100}:key{i} = {i}\n")
+        keys = [f"cat{i % 100}:key{i}" for i in range(LINES)]
+
+        def parse():
+            config = hyprlang.Config(conf)
+            for key in keys:
+                config.add(key, 0)
+            config.commence()
+            config.parse()
+            return config
+
+        parse().save_compiled(snap)
+
+        print(f"parse:                 {best(parse) * 1e3:8.3f} ms")
+        print(f"load_compiled:         {best(lambda: hyprlang.load_compiled(snap)) * 1e6:8.1f} us")
+        print(f"load_compiled (no validation): "
+              f"{best(lambda: hyprlang.load_compiled(snap, validate=False)) * 1e6:8.1f} us")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,76 @@
+"""Measure import time and first-Config latency.
+
+    uv run python benchmarks/bench_import.py
+
+Prints the cumulative `-X importtime` cost of hyprlang_pybind (and of _core,
+which is loaded on first use) plus the wall time from interpreter start to
+the first parsed Config, and exits non-zero when the first Config takes
+longer than FIRST_CONFIG_BUDGET.
+"""
+
+import subprocess
+import sys
+
+RUNS = 20
+
+# Best-of-RUNS wall time for the first Config, loading _core included.
+FIRST_CONFIG_BUDGET = 0.05
+
+FIRST_CONFIG = """
+import time
+t = time.perf_counter()
+import hyprlang_pybind as hyprlang
+t_import = time.perf_counter()
+config = hyprlang.Config("x = 1", is_stream=True)
+config.add("x", 0)
+config.commence()
+config.parse()
+t_config = time.perf_counter()
+print(t_import - t, t_config - t_import)
+"""
+
+
+def importtime(module: str) -> dict[str, int]:
+    """Cumulative microseconds per module reported by -X importtime."""
+    out = subprocess.run(
+        [sys.executable, "-X", "importtime", "-c", f"import {module}"],
+        capture_output=True, text=True, check=True,
+    )
+    result = {}
+    for line in out.stderr.splitlines():
+        if not line.startswith("import time:") or "|" not in line:
+            continue
+        _, cumulative, name = line[len("import time:"):].split("|")
+        if cumulative.strip().isdigit():
+            result[name.strip()] = int(cumulative)
+    return result
+
+
+def first_config() -> tuple[float, float]:
+    best_import = best_config = float("inf")
+    for _ in range(RUNS):
+        out = subprocess.run(
+            [sys.executable, "-c", FIRST_CONFIG],
+            capture_output=True, text=True, check=True,
+        )
+        t_import, t_config = map(float, out.stdout.split())
+        best_import = min(best_import, t_import)
+        best_config = min(best_config, t_config)
+    return best_import, best_config
+
+
+def main() -> None:
+    package = importtime("hyprlang_pybind")
+    core = importtime("hyprlang_pybind._core")
+    print(f"importtime hyprlang_pybind:        {package.get('hyprlang_pybind', 0):8d} us")
+    print(f"importtime hyprlang_pybind._core:  {core.get('hyprlang_pybind._core', 0):8d} us")
+
+    t_import, t_config = first_config()
+    print(f"import hyprlang_pybind (wall):     {t_import * 1e6:8.0f} us")
+    print(f"first Config parsed (wall):        {t_config * 1e6:8.0f} us")
+    if t_config > FIRST_CONFIG_BUDGET:
+        sys.exit(f"first Config over budget ({FIRST_CONFIG_BUDGET * 1e3:.0f} ms)")
+
+
+if __name__ == "__main__":
+    main()
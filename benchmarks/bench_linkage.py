@@ -0,0 +1,81 @@
+"""Compare the shared-library and vendored static builds of _core.
+
+Build the extension once per variant and run this script against each:
+
+    uv pip install -e . --no-build-isolation
+    uv run python benchmarks/bench_linkage.py
+
+    uv pip install -e . --no-build-isolation -C cmake.define.HYPRLANG_PYBIND_VENDOR=ON
+    uv run python benchmarks/bench_linkage.py
+
+The reported linkage comes from _core.HYPRLANG_LINKAGE.
+"""
+
+import subprocess
+import sys
+import time
+
+KEYS = 200
+ROUNDS = 50_000
+IMPORT_RUNS = 20
+
+
+def bench_import() -> float:
+    """Best wall time of importing _core in a fresh interpreter."""
+    best = float("inf")
+    code = (
+        "import time; t = time.perf_counter(); import hyprlang_pybind._core; "
+        "print(time.perf_counter() - t)"
+    )
+    for _ in range(IMPORT_RUNS):
+        out = subprocess.run(
+            [sys.executable, "-c", code], capture_output=True, text=True, check=True
+        )
+        best = min(best, float(out.stdout))
+    return best
+
+
+def make_config():
+    from hyprlang_pybind._core import Config, ConfigOptions
+
+    opts = ConfigOptions()
+    opts.path_is_stream = 1
+    text = "\n".join(f"cat:key{i} = {i}" for i in range(KEYS))
+    config = Config(text, opts)
+    for i in range(KEYS):
+        config.add_value(f"cat:key{i}", 0)
+    config.commence()
+    config.parse()
+    return config
+
+
+def bench_get_value(config) -> float:
+    names = [f"cat:key{i % KEYS}" for i in range(ROUNDS)]
+    get = config.get_value
+    t = time.perf_counter()
+    for name in names:
+        get(name)
+    return (time.perf_counter() - t) / ROUNDS
+
+
+def bench_parse_dynamic(config) -> float:
+    lines = [f"cat:key{i % KEYS} = {i}" for i in range(ROUNDS)]
+    parse = config.parse_dynamic
+    t = time.perf_counter()
+    for line in lines:
+        parse(line)
+    return (time.perf_counter() - t) / ROUNDS
+
+
+def main() -> None:
+    from hyprlang_pybind import _core
+
+    config = make_config()
+    print(f"linkage:        {_core.HYPRLANG_LINKAGE}")
+    print(f"import _core:   {bench_import() * 1e3:8.3f} ms")
+    print(f"get_value:      {bench_get_value(config) * 1e9:8.1f} ns/call")
+    print(f"parse_dynamic:  {bench_parse_dynamic(config) * 1e9:8.1f} ns/call")
+
+
+if __name__ == "__main__":
+    main()
@@ -2,11 +2,34 @@
 #include <pybind11/stl.h>
 #include <pybind11/functional.h>
 #include <hyprlang.hpp>
+#include "columns.hpp"
+#include "includes.hpp"
+#include "infer.hpp"
+#include "journal.hpp"
+#include "keyindex.hpp"
+#include "json.hpp"
+#include "layers.hpp"
+#include "limits.hpp"
+#include "live.hpp"
+#include "overlay.hpp"
+#include "prefetch.hpp"
+#include "registry.hpp"
+#include "shared.hpp"
+#include "snapshot.hpp"
+#include "sources.hpp"
+#include "tracking.hpp"
+#include "variables.hpp"
 #include <any>
+#include <list>
+#include <memory>
+#include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <filesystem>
+#include <unistd.h>
 
 namespace py = pybind11;
 
@@ -34,14 +57,457 @@ static py::object anyToPython(const std::any& val) {
     return py::none();
 }
 
+static py::object snapshotValueToPython(const Snapshot& snap, const SnapshotValue& val) {
+    switch (val.type) {
+        case ValueType::INT: return py::int_(val.data.i);
+        case ValueType::FLOAT: return py::float_(val.data.f);
+        case ValueType::STRING: {
+            auto s = snap.str(val.data.str);
+            return py::str(s.data(), s.size());
+        }
+        case ValueType::VEC2: return py::make_tuple(val.data.vec[0], val.data.vec[1]);
+        default: return py::none();
+    }
+}
+
+static py::object overlayValueToPython(const OverlayValue& val) {
+    switch (val.type) {
+        case ValueType::INT: return py::int_(val.i);
+        case ValueType::FLOAT: return py::float_(val.f);
+        case ValueType::STRING: return py::str(val.str);
+        case ValueType::VEC2: return py::make_tuple(val.vec[0], val.vec[1]);
+        default: return py::none();
+    }
+}
+
+// Copies a numeric column into bytes and returns it as a typed memoryview.
+template <typename T>
+static py::object packedColumn(const std::vector<T>& values) {
+    py::bytes raw(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    return py::memoryview(raw).attr("cast")(py::format_descriptor<T>::format());
+}
+
+// Inserts `value` under a colon-separated `name`, creating nested dicts.
+static void setNested(py::dict& root, std::string_view name, py::object value) {
+    py::dict current = root;
+    size_t   start   = 0;
+    for (size_t pos = name.find(':'); pos != std::string_view::npos; pos = name.find(':', start)) {
+        py::str part(name.data() + start, pos - start);
+        if (!current.contains(part))
+            current[part] = py::dict();
+        current = current[part].cast<py::dict>();
+        start   = pos + 1;
+    }
+    current[py::str(name.data() + start, name.size() - start)] = std::move(value);
+}
+
+// Keeps a Python buffer export alive for a snapshot that reads from it in place.
+struct PyBufferOwner {
+    Py_buffer view{};
+
+    ~PyBufferOwner() {
+        py::gil_scoped_acquire gil;
+        PyBuffer_Release(&view);
+    }
+};
+
+// Returns the text of a str (its cached UTF-8 form) or of any contiguous
+// buffer-protocol object, without copying. `owner` holds the buffer export and
+// must outlive the view.
+static std::string_view textView(py::handle obj, PyBufferOwner& owner) {
+    if (PyUnicode_Check(obj.ptr())) {
+        Py_ssize_t  size = 0;
+        const char* data = PyUnicode_AsUTF8AndSize(obj.ptr(), &size);
+        if (!data)
+            throw py::error_already_set();
+        return {data, static_cast<size_t>(size)};
+    }
+
+    if (PyObject_GetBuffer(obj.ptr(), &owner.view, PyBUF_SIMPLE) != 0)
+        throw py::error_already_set();
+    return {static_cast<const char*>(owner.view.buf), static_cast<size_t>(owner.view.len)};
+}
+
+// The CConfig behind the low-level Config, with the state the bindings keep
+// per config.
+struct PyConfig : Hyprlang::CConfig {
+    using Hyprlang::CConfig::CConfig;
+
+    ChangeTracker                  changes;
+    std::shared_ptr<ChangeJournal> journal; // null unless enabled
+
+    // values registered with add_value, in order; indexed at commence(),
+    // which also fills in the value pointers
+    std::vector<KeyIndex::Entry> keys;
+    KeyIndex                     index;
+
+    const KeyIndex&              committedIndex() const {
+        if (!index.built())
+            throw std::runtime_error("Keys can only be queried after commence()");
+        return index;
+    }
+
+    // a stream root's text is kept only when the limits, variables or the
+    // source cache need it
+    ParseLimits limits;
+    std::string root;
+    bool        rootIsStream    = false;
+    size_t      prefetchThreads = 0; // 0 when prefetching is off
+
+    // Configs created with the source cache or with variables are streams
+    // over STREAM_PLACEHOLDER, so the text hyprlang parses is never rebuilt:
+    // parse() resets them with parse(), defines `variables` with
+    // parseDynamic() and then parseFile()s the root. A stream root is read
+    // from `memFile`, written once with the template; with the source cache
+    // the root is expanded into `memFile` from SourceCache::shared() instead.
+    // A stream root's relative includes resolve against `streamBase`.
+    bool                                             placeholderRoot = false;
+    bool                                             useSourceCache  = false;
+    bool                                             allowMissing    = false;
+    std::string                                      streamBase;
+    std::optional<MemFile>                           memFile;
+    std::vector<std::pair<std::string, std::string>> variables;
+
+    void                                             writeTemplate() {
+        if (!memFile)
+            memFile.emplace();
+        memFile->write(absoluteSourceLines(root, streamBase));
+    }
+
+    Hyprlang::CParseResult parseRoot() {
+        if (!placeholderRoot)
+            return parse();
+
+        auto result = parse();
+        for (const auto& line : variableLines(variables)) {
+            if (result.error)
+                return result;
+            result = parseDynamic(line.c_str());
+        }
+        if (result.error)
+            return result;
+
+        if (useSourceCache) {
+            if (!rootIsStream && allowMissing && access(root.c_str(), F_OK) != 0)
+                return result;
+            LineMap map;
+            try {
+                py::gil_scoped_release release;
+                if (!memFile)
+                    memFile.emplace();
+                memFile->write(expandSources(root, rootIsStream, SourceCache::shared(), streamBase, &map));
+            } catch (const std::exception& e) {
+                result.setError(e.what());
+                return result;
+            }
+            // report errors against the files the lines came from, not the memfd
+            result = parseFile(memFile->path().c_str());
+            if (result.error && result.getError())
+                result.setError(map.rewriteError(result.getError(), memFile->path()).c_str());
+            return result;
+        }
+
+        if (rootIsStream)
+            return parseFile(memFile->path().c_str());
+        if (!allowMissing || access(root.c_str(), F_OK) == 0)
+            result = parseFile(root.c_str());
+        return result;
+    }
+
+    // Runs parse() or parseFile() on `pathOrText`: the inputs are pre-scanned
+    // against the limits and their includes prefetched before hyprlang sees
+    // them, and the deadline is checked again after.
+    template <typename F>
+    Hyprlang::CParseResult runParse(const std::string& pathOrText, bool isStream, F&& parseFn) {
+        const auto start = std::chrono::steady_clock::now();
+        if (limits.any())
+            checkParseLimits(pathOrText, isStream, limits, start);
+        if (prefetchThreads && !isStream && !pathOrText.empty()) {
+            py::gil_scoped_release release;
+            prefetchSourceFiles({pathOrText}, prefetchThreads);
+        }
+        auto result = parseFn();
+        changes.markAll();
+        checkParseDeadline(limits, start);
+        return result;
+    }
+};
+
+// What a placeholder-backed config is constructed over; the real text is
+// handed to hyprlang with parseFile().
+constexpr const char* STREAM_PLACEHOLDER = "# hyprlang-pybind\n";
+
+static PyConfig* createConfig(const char* path, const Hyprlang::SConfigOptions& opts, const ParseLimits& limits = {}, bool sourceCache = false,
+                              std::optional<py::dict> variables = std::nullopt) {
+    std::vector<std::pair<std::string, std::string>> list;
+    if (variables) {
+        for (auto [name, value] : *variables)
+            list.emplace_back(py::str(name), py::str(value));
+        variableLines(list); // validates
+    }
+
+    try {
+        std::unique_ptr<PyConfig> config;
+        const bool                placeholder = sourceCache || variables;
+        if (placeholder) {
+            if (!opts.pathIsStream && !opts.allowMissingConfig && access(path, F_OK) != 0)
+                throw std::runtime_error("File does not exist");
+            auto streamOpts         = opts;
+            streamOpts.pathIsStream = true;
+            config                  = std::make_unique<PyConfig>(STREAM_PLACEHOLDER, streamOpts);
+            config->placeholderRoot = true;
+            config->useSourceCache  = sourceCache;
+            config->allowMissing    = opts.allowMissingConfig;
+        } else
+            config = std::make_unique<PyConfig>(path, opts);
+
+        // a plain stream is parsed from hyprlang's own copy
+        if (!opts.pathIsStream || placeholder || limits.any())
+            config->root = path;
+        config->limits       = limits;
+        config->rootIsStream = opts.pathIsStream;
+        config->variables    = std::move(list);
+        if (placeholder && opts.pathIsStream && !sourceCache)
+            config->writeTemplate();
+        return config.release();
+    } catch (const std::exception& e) {
+        throw std::runtime_error(std::string("Failed to create config: ") + e.what());
+    } catch (...) {
+        throw std::runtime_error(std::string("Failed to create config for path: ") + path);
+    }
+}
+
+constexpr size_t KEY_PATH_CACHE_SIZE = 4096;
+
+// Joins the components of a tuple key path with ':'.
+static void joinKeyPath(PyObject* tuple, std::string& out) {
+    out.clear();
+    const auto parts = PyTuple_GET_SIZE(tuple);
+    for (Py_ssize_t i = 0; i < parts; ++i) {
+        Py_ssize_t  size = 0;
+        const char* data = PyUnicode_AsUTF8AndSize(PyTuple_GET_ITEM(tuple, i), &size);
+        if (!data)
+            throw py::error_already_set();
+        if (i)
+            out += ':';
+        out.append(data, size);
+    }
+}
+
+// Joined tuple key paths, least recently used last. Entries are keyed by the
+// tuple's hash and compared by value, so equal tuples built afresh for each
+// lookup share one entry. Each entry holds a reference to the first tuple seen
+// with its value, to compare against.
+struct KeyPathCache {
+    struct Entry {
+        PyObject*   tuple;
+        Py_hash_t   hash;
+        std::string name;
+    };
+
+    std::list<Entry>                                                lru;
+    std::unordered_multimap<Py_hash_t, std::list<Entry>::iterator> index;
+};
+
+// Resolves a key given as a str or as a tuple path such as
+// ("general", "snap", "enabled"), which is joined with ':'. Joined paths are
+// cached, so repeated lookups don't build a string each time. Only exact
+// tuples of exact str are cached, as hashing and comparing those runs no
+// Python code. The pointer is valid until the next call.
+static const char* keyName(py::handle key) {
+    if (PyUnicode_Check(key.ptr())) {
+        const char* name = PyUnicode_AsUTF8(key.ptr());
+        if (!name)
+            throw py::error_already_set();
+        return name;
+    }
+    if (!PyTuple_Check(key.ptr()))
+        throw py::type_error("key must be a str or a tuple of str");
+
+    bool cacheable = PyTuple_CheckExact(key.ptr());
+    for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(key.ptr()); ++i) {
+        PyObject* part = PyTuple_GET_ITEM(key.ptr(), i);
+        if (!PyUnicode_Check(part))
+            throw py::type_error("key path components must be str");
+        cacheable = cacheable && PyUnicode_CheckExact(part);
+    }
+
+    static std::string uncached;
+    if (!cacheable) {
+        joinKeyPath(key.ptr(), uncached);
+        return uncached.c_str();
+    }
+
+    const Py_hash_t hash = PyObject_Hash(key.ptr());
+    if (hash == -1)
+        throw py::error_already_set();
+
+    // leaked on purpose: the references must not be dropped after finalization
+    static auto* cache = new KeyPathCache();
+    for (auto [it, end] = cache->index.equal_range(hash); it != end; ++it) {
+        auto entry = it->second;
+        if (entry->tuple != key.ptr() && PyObject_RichCompareBool(entry->tuple, key.ptr(), Py_EQ) != 1)
+            continue;
+        cache->lru.splice(cache->lru.begin(), cache->lru, entry);
+        return entry->name.c_str();
+    }
+
+    std::string joined;
+    joinKeyPath(key.ptr(), joined);
+    Py_INCREF(key.ptr());
+    cache->lru.push_front({key.ptr(), hash, std::move(joined)});
+    cache->index.emplace(hash, cache->lru.begin());
+
+    while (cache->lru.size() > KEY_PATH_CACHE_SIZE) {
+        auto victim = std::prev(cache->lru.end());
+        for (auto [it, end] = cache->index.equal_range(victim->hash); it != end; ++it) {
+            if (it->second == victim) {
+                cache->index.erase(it);
+                break;
+            }
+        }
+        Py_DECREF(victim->tuple);
+        cache->lru.erase(victim);
+    }
+    return cache->lru.front().name.c_str();
+}
+
+static SchemaEntry schemaEntry(const std::string& name, py::handle defaultVal) {
+    SchemaEntry entry{.name = name};
+    if (py::isinstance<py::int_>(defaultVal)) {
+        entry.type = ValueType::INT;
+        entry.i    = defaultVal.cast<int64_t>();
+    } else if (py::isinstance<py::float_>(defaultVal)) {
+        entry.type = ValueType::FLOAT;
+        entry.f    = defaultVal.cast<float>();
+    } else if (py::isinstance<py::str>(defaultVal)) {
+        entry.type = ValueType::STRING;
+        entry.str  = defaultVal.cast<std::string>();
+    } else if (py::isinstance<Hyprlang::SVector2D>(defaultVal)) {
+        entry.type = ValueType::VEC2;
+        entry.vec  = defaultVal.cast<Hyprlang::SVector2D>();
+    } else if (py::isinstance<py::tuple>(defaultVal) && py::len(defaultVal) == 2) {
+        auto t     = defaultVal.cast<py::tuple>();
+        entry.type = ValueType::VEC2;
+        entry.vec  = Hyprlang::SVector2D{t[0].cast<float>(), t[1].cast<float>()};
+    } else {
+        throw std::invalid_argument("Unsupported default value type. Use int, float, str, SVector2D, or tuple(float, float).");
+    }
+    return entry;
+}
+
+[[noreturn]] static void throwKeyError(py::handle key) {
+    PyErr_SetObject(PyExc_KeyError, key.ptr());
+    throw py::error_already_set();
+}
+
+// Override if the overlay has one, else the base value, else None.
+static py::object overlayGet(const ConfigOverlay& overlay, py::handle name) {
+    const char* key = keyName(name);
+    if (auto* val = overlay.findOverride(key))
+        return overlayValueToPython(*val);
+    if (auto* val = overlay.base().find(key))
+        return snapshotValueToPython(overlay.base(), *val);
+    return py::none();
+}
+
+// Rebuilds a snapshot from a pickled image. Read-only, aligned buffers (bytes,
+// out-of-band PickleBuffers) are used in place; anything else is copied.
+static std::shared_ptr<Snapshot> snapshotFromBuffer(py::object obj) {
+    auto owner = std::make_shared<PyBufferOwner>();
+    if (PyObject_GetBuffer(obj.ptr(), &owner->view, PyBUF_SIMPLE) != 0)
+        throw py::error_already_set();
+
+    const auto* data = static_cast<const uint8_t*>(owner->view.buf);
+    const auto  size = static_cast<size_t>(owner->view.len);
+    if (!owner->view.readonly || reinterpret_cast<uintptr_t>(data) % alignof(SnapshotHeader) != 0)
+        return Snapshot::fromBytes(std::vector<uint8_t>(data, data + size));
+    return std::make_shared<Snapshot>(std::move(owner), data, size);
+}
+
+// ConfigRegistry plus the Python callable that maps a tenant id to its
+// config path (str or os.PathLike) or text (bytes).
+struct PyConfigRegistry : ConfigRegistry {
+    PyConfigRegistry(std::vector<SchemaEntry> schema, size_t maxBytes, size_t maxEntries, size_t shards, py::function loader) :
+        ConfigRegistry(std::move(schema), maxBytes, maxEntries, shards), loader(std::move(loader)) {}
+
+    py::function loader;
+};
+
 struct ConfigValueProxy {
     py::object value;
     bool       setByUser;
 };
 
+// Leaf attribute of Config.attrs. Holds the resolved value (CConfigValue
+// addresses are stable once registered) and a reference to the owning config.
+// A plain CPython type rather than a pybind class: its tp_descr_get slot is
+// called directly by attribute lookup, so a read skips pybind's argument
+// dispatch and costs about as much as a slot access plus the conversion.
+struct ValueDescriptorObject {
+    PyObject_HEAD
+    PyObject*               config;
+    Hyprlang::CConfigValue* value;
+};
+
+static PyObject* valueDescriptorGet(PyObject* self, PyObject* obj, PyObject*) {
+    if (!obj || obj == Py_None)
+        return Py_NewRef(self);
+    try {
+        return anyToPython(reinterpret_cast<ValueDescriptorObject*>(self)->value->getValue()).release().ptr();
+    } catch (py::error_already_set& e) {
+        e.restore();
+        return nullptr;
+    }
+}
+
+static PyObject* valueDescriptorRepr(PyObject* self) {
+    try {
+        auto value = anyToPython(reinterpret_cast<ValueDescriptorObject*>(self)->value->getValue());
+        return py::str("ValueDescriptor({})").format(py::repr(value)).release().ptr();
+    } catch (py::error_already_set& e) {
+        e.restore();
+        return nullptr;
+    }
+}
+
+static void valueDescriptorDealloc(PyObject* self) {
+    auto* type = Py_TYPE(self);
+    Py_XDECREF(reinterpret_cast<ValueDescriptorObject*>(self)->config);
+    type->tp_free(self);
+    Py_DECREF(type);
+}
+
+static PyType_Slot valueDescriptorSlots[] = {
+    {Py_tp_descr_get, reinterpret_cast<void*>(valueDescriptorGet)},
+    {Py_tp_repr, reinterpret_cast<void*>(valueDescriptorRepr)},
+    {Py_tp_dealloc, reinterpret_cast<void*>(valueDescriptorDealloc)},
+    {0, nullptr},
+};
+
+static PyType_Spec valueDescriptorSpec = {
+    "hyprlang_pybind._core.ValueDescriptor", sizeof(ValueDescriptorObject), 0, Py_TPFLAGS_DEFAULT | Py_TPFLAGS_DISALLOW_INSTANTIATION, valueDescriptorSlots,
+};
+
+static PyTypeObject* valueDescriptorType = nullptr;
+
 PYBIND11_MODULE(_core, m) {
     m.doc() = "Low-level Python bindings for hyprlang";
 
+#ifdef HYPRLANG_PYBIND_VENDORED
+    m.attr("HYPRLANG_LINKAGE") = "static";
+#else
+    m.attr("HYPRLANG_LINKAGE") = "shared";
+#endif
+
+    py::enum_<ValueType>(m, "ValueType")
+        .value("EMPTY", ValueType::EMPTY)
+        .value("INT", ValueType::INT)
+        .value("FLOAT", ValueType::FLOAT)
+        .value("STRING", ValueType::STRING)
+        .value("VEC2", ValueType::VEC2)
+        .value("CUSTOM", ValueType::CUSTOM);
+
     py::class_<Hyprlang::SVector2D>(m, "SVector2D")
         .def(py::init<>())
         .def(py::init([](float x, float y) {
@@ -82,6 +548,30 @@ PYBIND11_MODULE(_core, m) {
         .def_readwrite("allow_missing_config", &Hyprlang::SConfigOptions::allowMissingConfig)
         .def_readwrite("path_is_stream", &Hyprlang::SConfigOptions::pathIsStream);
 
+    py::register_exception<LimitError>(m, "LimitError", PyExc_RuntimeError);
+
+    // the OSError subclass follows from errno, as for open()
+    py::register_exception_translator([](std::exception_ptr p) {
+        try {
+            if (p)
+                std::rethrow_exception(p);
+        } catch (const FileReadError& e) {
+            errno = e.error();
+            PyErr_SetFromErrnoWithFilename(PyExc_OSError, e.path().c_str());
+        }
+    });
+
+    py::class_<ParseLimits>(m, "ParseLimits")
+        .def(py::init<>())
+        .def(py::init([](size_t maxBytes, size_t maxIncludeDepth, size_t maxLines, double timeout) {
+            return ParseLimits{maxBytes, maxIncludeDepth, maxLines, timeout};
+        }), py::kw_only(), py::arg("max_bytes") = 0, py::arg("max_include_depth") = 0, py::arg("max_lines") = 0, py::arg("timeout") = 0.0)
+        .def_readwrite("max_bytes", &ParseLimits::maxBytes)
+        .def_readwrite("max_include_depth", &ParseLimits::maxIncludeDepth)
+        .def_readwrite("max_lines", &ParseLimits::maxLines)
+        .def_readwrite("timeout", &ParseLimits::timeout)
+        .def("__bool__", &ParseLimits::any);
+
     py::class_<Hyprlang::SHandlerOptions>(m, "HandlerOptions")
         .def(py::init<>())
         .def_readwrite("allow_flags", &Hyprlang::SHandlerOptions::allowFlags);
@@ -102,72 +592,672 @@ PYBIND11_MODULE(_core, m) {
             return "ConfigValueProxy(set_by_user=" + std::string(p.setByUser ? "True" : "False") + ")";
         });
 
-    py::class_<Hyprlang::CConfig>(m, "Config")
-        .def(py::init([](const std::string& path, const Hyprlang::SConfigOptions& opts) {
-            try {
-                return new Hyprlang::CConfig(path.c_str(), opts);
-            } catch (const std::exception& e) {
-                throw std::runtime_error(std::string("Failed to create config: ") + e.what());
-            } catch (...) {
-                throw std::runtime_error("Failed to create config for path: " + path);
+    py::class_<JournalEntry>(m, "JournalEntry")
+        .def_readonly("seq", &JournalEntry::seq)
+        .def_readonly("command", &JournalEntry::command)
+        .def_readonly("value", &JournalEntry::value)
+        .def_readonly("timestamp", &JournalEntry::timestamp)
+        .def_readonly("ok", &JournalEntry::ok)
+        .def_readonly("error", &JournalEntry::error)
+        .def("__repr__", [](const JournalEntry& e) {
+            return "JournalEntry(seq=" + std::to_string(e.seq) + ", command=" + py::repr(py::str(e.command)).cast<std::string>() +
+                ", value=" + py::repr(py::str(e.value)).cast<std::string>() + ", ok=" + (e.ok ? "True" : "False") + ")";
+        });
+
+    py::class_<ChangeJournal, std::shared_ptr<ChangeJournal>>(m, "ChangeJournal")
+        .def("since", &ChangeJournal::since, py::arg("seq"))
+        .def_property_readonly("last_seq", &ChangeJournal::lastSeq)
+        .def_property_readonly("capacity", &ChangeJournal::capacity)
+        .def("__len__", &ChangeJournal::size);
+
+    valueDescriptorType = reinterpret_cast<PyTypeObject*>(PyType_FromSpec(&valueDescriptorSpec));
+    if (!valueDescriptorType)
+        throw py::error_already_set();
+    m.attr("ValueDescriptor") = py::handle(reinterpret_cast<PyObject*>(valueDescriptorType));
+
+    py::class_<Snapshot, std::shared_ptr<Snapshot>>(m, "ConfigSnapshot", py::buffer_protocol())
+        .def_buffer([](const Snapshot& self) {
+            return py::buffer_info(const_cast<uint8_t*>(self.data()), 1, py::format_descriptor<uint8_t>::format(), 1, {static_cast<py::ssize_t>(self.nbytes())}, {1}, true);
+        })
+
+        .def("__reduce_ex__", [](py::object self, int protocol) {
+            auto fromBuffer = py::module_::import("hyprlang_pybind._core").attr("_snapshot_from_buffer");
+            if (protocol >= 5)
+                return py::make_tuple(fromBuffer, py::make_tuple(py::module_::import("pickle").attr("PickleBuffer")(self)));
+            const auto& snap = self.cast<const Snapshot&>();
+            return py::make_tuple(fromBuffer, py::make_tuple(py::bytes(reinterpret_cast<const char*>(snap.data()), snap.nbytes())));
+        }, py::arg("protocol"))
+
+        .def("get", [](const Snapshot& self, py::handle name, py::object defaultVal) -> py::object {
+            auto* val = self.find(keyName(name));
+            return val ? snapshotValueToPython(self, *val) : defaultVal;
+        }, py::arg("name"), py::arg("default") = py::none())
+
+        .def("get_values", [](const Snapshot& self, py::iterable names) {
+            py::list result;
+            for (auto name : names) {
+                auto* val = self.find(keyName(name));
+                result.append(val ? snapshotValueToPython(self, *val) : py::none());
             }
-        }), py::arg("path"), py::arg("options") = Hyprlang::SConfigOptions{})
+            return result;
+        }, py::arg("names"))
 
-        .def("add_value", [](Hyprlang::CConfig& self, const std::string& name, py::object defaultVal) {
-            if (py::isinstance<py::int_>(defaultVal)) {
-                self.addConfigValue(name.c_str(), Hyprlang::CConfigValue((Hyprlang::INT)defaultVal.cast<int64_t>()));
-            } else if (py::isinstance<py::float_>(defaultVal)) {
-                self.addConfigValue(name.c_str(), Hyprlang::CConfigValue((Hyprlang::FLOAT)defaultVal.cast<float>()));
-            } else if (py::isinstance<py::str>(defaultVal)) {
-                self.addConfigValue(name.c_str(), Hyprlang::CConfigValue((Hyprlang::STRING)defaultVal.cast<std::string>().c_str()));
-            } else if (py::isinstance<Hyprlang::SVector2D>(defaultVal)) {
-                self.addConfigValue(name.c_str(), Hyprlang::CConfigValue(defaultVal.cast<Hyprlang::SVector2D>()));
-            } else if (py::isinstance<py::tuple>(defaultVal) && py::len(defaultVal) == 2) {
-                auto t = defaultVal.cast<py::tuple>();
-                Hyprlang::SVector2D vec{t[0].cast<float>(), t[1].cast<float>()};
-                self.addConfigValue(name.c_str(), Hyprlang::CConfigValue(vec));
-            } else {
-                throw std::invalid_argument("Unsupported default value type. Use int, float, str, SVector2D, or tuple(float, float).");
+        .def("__getitem__", [](const Snapshot& self, py::handle name) -> py::object {
+            auto* val = self.find(keyName(name));
+            if (!val)
+                throwKeyError(name);
+            return snapshotValueToPython(self, *val);
+        }, py::arg("name"))
+
+        .def("__contains__", [](const Snapshot& self, py::handle name) {
+            return self.find(keyName(name)) != nullptr;
+        }, py::arg("name"))
+
+        .def("__len__", &Snapshot::keyCount)
+
+        .def("keys", [](const Snapshot& self) {
+            py::list result(self.keyCount());
+            for (size_t i = 0; i < self.keyCount(); ++i) {
+                auto name = self.keyName(i);
+                result[i] = py::str(name.data(), name.size());
+            }
+            return result;
+        })
+
+        .def("is_set_by_user", [](const Snapshot& self, py::handle name) {
+            auto* val = self.find(keyName(name));
+            if (!val)
+                throwKeyError(name);
+            return val->setByUser != 0;
+        }, py::arg("name"))
+
+        .def("origin", [](const Snapshot& self, py::handle name) -> py::object {
+            auto* val = self.find(keyName(name));
+            if (!val)
+                throwKeyError(name);
+            return val->layer ? py::int_(val->layer - 1) : py::none();
+        }, py::arg("name"))
+
+        .def("get_special", [](const Snapshot& self, const std::string& cat, py::handle name, py::object key) -> py::object {
+            std::string keyStr = key.is_none() ? std::string{} : key.cast<std::string>();
+            auto*       val    = self.findSpecial(cat, keyName(name), keyStr);
+            return val ? snapshotValueToPython(self, *val) : py::none();
+        }, py::arg("category"), py::arg("name"), py::arg("key") = py::none())
+
+        .def("list_special_keys", [](const Snapshot& self, const std::string& cat) {
+            py::list result;
+            for (auto key : self.specialKeys(cat))
+                result.append(py::str(key.data(), key.size()));
+            return result;
+        }, py::arg("category"))
+
+        .def("special_category_exists", [](const Snapshot& self, const std::string& cat, const std::string& key) {
+            for (auto k : self.specialKeys(cat)) {
+                if (k == key)
+                    return true;
+            }
+            return false;
+        }, py::arg("category"), py::arg("key"))
+
+        .def("to_dict", [](const Snapshot& self) {
+            py::dict result;
+            for (size_t i = 0; i < self.keyCount(); ++i)
+                setNested(result, self.keyName(i), snapshotValueToPython(self, self.valueAt(i)));
+            return result;
+        })
+
+        .def("to_json", [](const Snapshot& self, std::optional<int> indent, bool allowNan) {
+            std::string out;
+            {
+                py::gil_scoped_release release;
+                out = snapshotToJson(self, indent.value_or(-1), allowNan);
+            }
+            return py::str(out);
+        }, py::arg("indent") = py::none(), py::kw_only(), py::arg("allow_nan") = false)
+
+        .def_property_readonly("sources", [](const Snapshot& self) {
+            py::list result;
+            for (size_t i = 0; i < self.sourceCount(); ++i) {
+                auto path = self.sourcePath(i);
+                result.append(py::str(path.data(), path.size()));
+            }
+            return result;
+        })
+
+        .def_property_readonly("nbytes", &Snapshot::nbytes)
+
+        .def("is_current", &Snapshot::sourcesUnchanged, py::call_guard<py::gil_scoped_release>())
+
+        .def("save", &Snapshot::save, py::arg("path"), py::call_guard<py::gil_scoped_release>())
+
+        .def("__repr__", [](const Snapshot& self) {
+            return "ConfigSnapshot(keys=" + std::to_string(self.keyCount()) + ", nbytes=" + std::to_string(self.nbytes()) + ")";
+        });
+
+    m.def("parse_snapshot", [](const std::string& pathOrText, const std::vector<std::pair<std::string, py::object>>& schema, bool isStream) {
+        std::vector<SchemaEntry> entries;
+        entries.reserve(schema.size());
+        for (const auto& [name, defaultVal] : schema)
+            entries.push_back(schemaEntry(name, defaultVal));
+
+        py::gil_scoped_release release;
+        return parseSnapshot(pathOrText, isStream, entries);
+    }, py::arg("path"), py::arg("schema"), py::arg("is_stream") = false);
+
+    // None while the parse cache is off; a None schema is inferred on a miss
+    m.def("parse_cached", [](py::object data, std::optional<std::vector<std::pair<std::string, py::object>>> schema, bool isStream,
+                             const Hyprlang::SConfigOptions& opts) -> std::shared_ptr<Snapshot> {
+        auto cache = ParseCache::shared();
+        if (!cache)
+            return nullptr;
+
+        PyBufferOwner                           owner;
+        const auto                              pathOrText = textView(data, owner);
+        std::optional<std::vector<SchemaEntry>> entries;
+        if (schema) {
+            entries.emplace();
+            entries->reserve(schema->size());
+            for (const auto& [name, defaultVal] : *schema)
+                entries->push_back(schemaEntry(name, defaultVal));
+        }
+
+        py::gil_scoped_release release;
+        return cache->parse(pathOrText, isStream, entries, opts);
+    }, py::arg("path"), py::arg("schema"), py::arg("is_stream") = false, py::arg("options") = Hyprlang::SConfigOptions{});
+
+    m.def("enable_parse_cache", [](size_t maxBytes, size_t maxEntries, size_t shards) {
+        ParseCache::setShared(std::make_shared<ParseCache>(maxBytes, maxEntries, shards));
+    }, py::arg("max_bytes") = 64 << 20, py::arg("max_entries") = 0, py::arg("shards") = 16);
+    m.def("disable_parse_cache", [] { ParseCache::setShared(nullptr); });
+
+    m.def("parse_cache_stats", []() -> py::object {
+        auto cache = ParseCache::shared();
+        if (!cache)
+            return py::none();
+        auto     stats = cache->stats();
+        py::dict result;
+        result["hits"]      = stats.hits;
+        result["misses"]    = stats.misses;
+        result["evictions"] = stats.evictions;
+        result["entries"]   = stats.entries;
+        result["nbytes"]    = stats.nbytes;
+        return result;
+    });
+
+    py::class_<LiveSnapshot>(m, "LiveSnapshot")
+        .def(py::init<std::shared_ptr<Snapshot>>(), py::arg("snapshot"))
+        .def("current", &LiveSnapshot::current)
+        .def_property_readonly("version", &LiveSnapshot::version)
+        .def("publish", &LiveSnapshot::publish, py::arg("snapshot"), py::call_guard<py::gil_scoped_release>())
+
+        .def("get", [](const LiveSnapshot& self, py::handle name, py::object defaultVal) -> py::object {
+            auto  snap = self.current();
+            auto* val  = snap->find(keyName(name));
+            return val ? snapshotValueToPython(*snap, *val) : defaultVal;
+        }, py::arg("name"), py::arg("default") = py::none())
+
+        .def("__getitem__", [](const LiveSnapshot& self, py::handle name) -> py::object {
+            auto  snap = self.current();
+            auto* val  = snap->find(keyName(name));
+            if (!val)
+                throwKeyError(name);
+            return snapshotValueToPython(*snap, *val);
+        }, py::arg("name"))
+
+        .def("__contains__", [](const LiveSnapshot& self, py::handle name) {
+            return self.current()->find(keyName(name)) != nullptr;
+        }, py::arg("name"));
+
+    m.def("parse_layered", [](const std::vector<std::string>& paths, const std::vector<std::pair<std::string, py::object>>& schema, bool allowMissing) {
+        std::vector<SchemaEntry> entries;
+        entries.reserve(schema.size());
+        for (const auto& [name, defaultVal] : schema)
+            entries.push_back(schemaEntry(name, defaultVal));
+
+        py::gil_scoped_release release;
+        return parseLayered(paths, entries, allowMissing);
+    }, py::arg("paths"), py::arg("schema"), py::arg("allow_missing") = false);
+
+    m.def("load_snapshot", &Snapshot::mapFile, py::arg("path"), py::call_guard<py::gil_scoped_release>());
+    m.def("_snapshot_from_buffer", &snapshotFromBuffer, py::arg("buffer"));
+
+    m.def("prefetch_sources", [](const std::vector<std::string>& paths, size_t threads) {
+        auto stats = prefetchSourceFiles(paths, threads);
+        return py::make_tuple(stats.files, stats.bytes);
+    }, py::arg("paths"), py::arg("threads") = 8, py::call_guard<py::gil_scoped_release>());
+
+    m.def("source_cache_stats", [] {
+        auto     stats = SourceCache::shared().stats();
+        py::dict result;
+        result["hits"]      = stats.hits;
+        result["misses"]    = stats.misses;
+        result["evictions"] = stats.evictions;
+        result["entries"]   = stats.entries;
+        result["nbytes"]    = stats.nbytes;
+        result["max_bytes"] = stats.maxBytes;
+        return result;
+    });
+    m.def("set_source_cache_size", [](size_t maxBytes) { SourceCache::shared().setMaxBytes(maxBytes); }, py::arg("max_bytes"));
+    m.def("clear_source_cache", [] { SourceCache::shared().clear(); });
+
+    m.def("publish_shared", &publishSharedSnapshot, py::arg("name"), py::arg("snapshot"), py::call_guard<py::gil_scoped_release>());
+    m.def("unlink_shared", &unlinkSharedSnapshot, py::arg("name"), py::call_guard<py::gil_scoped_release>());
+
+    py::class_<Bundle, std::shared_ptr<Bundle>>(m, "Bundle")
+        .def_static("from_text", [](py::object text) {
+            PyBufferOwner owner;
+            return Bundle::fromText(std::string{textView(text, owner)});
+        }, py::arg("text"))
+        .def_property_readonly("text", &Bundle::text)
+        .def_property_readonly("hash", &Bundle::hash)
+        .def_property_readonly("files", &Bundle::files)
+        .def("origin", &Bundle::origin, py::arg("line"))
+        .def("annotate_error", &Bundle::annotateError, py::arg("message"))
+        .def("is_current", &Bundle::isCurrent)
+        .def("__repr__", [](const Bundle& self) {
+            return "Bundle(files=" + std::to_string(self.files().size()) + ", bytes=" + std::to_string(self.text().size()) + ")";
+        });
+
+    m.def("bundle", [](const std::string& path) {
+        return Bundle::build(path, SourceCache::shared());
+    }, py::arg("path"), py::call_guard<py::gil_scoped_release>());
+
+    py::class_<SharedSnapshotView>(m, "SharedConfig")
+        .def(py::init<const std::string&>(), py::arg("name"))
+        .def_property_readonly("generation", &SharedSnapshotView::generation)
+        .def("snapshot", &SharedSnapshotView::current)
+
+        .def("get", [](SharedSnapshotView& self, py::handle name, py::object defaultVal) -> py::object {
+            auto  snap = self.current();
+            auto* val  = snap->find(keyName(name));
+            return val ? snapshotValueToPython(*snap, *val) : defaultVal;
+        }, py::arg("name"), py::arg("default") = py::none())
+
+        .def("__getitem__", [](SharedSnapshotView& self, py::handle name) -> py::object {
+            auto  snap = self.current();
+            auto* val  = snap->find(keyName(name));
+            if (!val)
+                throwKeyError(name);
+            return snapshotValueToPython(*snap, *val);
+        }, py::arg("name"))
+
+        .def("__contains__", [](SharedSnapshotView& self, py::handle name) {
+            return self.current()->find(keyName(name)) != nullptr;
+        }, py::arg("name"));
+
+    py::class_<OverlayBase, std::shared_ptr<OverlayBase>>(m, "OverlayBase")
+        .def(py::init<std::shared_ptr<Snapshot>>(), py::arg("snapshot"))
+        .def_property_readonly("snapshot", &OverlayBase::snapshot)
+        .def("overlay", [](const std::shared_ptr<OverlayBase>& self) {
+            return std::make_shared<ConfigOverlay>(self);
+        });
+
+    py::class_<ConfigOverlay, std::shared_ptr<ConfigOverlay>>(m, "ConfigOverlay")
+        .def("parse_dynamic", py::overload_cast<std::string_view>(&ConfigOverlay::parseDynamic), py::arg("line"))
+        .def("parse_dynamic_kv", py::overload_cast<const std::string&, const std::string&>(&ConfigOverlay::parseDynamic), py::arg("command"), py::arg("value"))
+
+        .def("get_value", &overlayGet, py::arg("name"))
+
+        .def("get_values", [](const ConfigOverlay& self, py::iterable names) {
+            py::list result;
+            for (auto name : names)
+                result.append(overlayGet(self, name));
+            return result;
+        }, py::arg("names"))
+
+        .def("is_set_by_user", [](const ConfigOverlay& self, py::handle name) {
+            const char* key = keyName(name);
+            if (self.findOverride(key))
+                return true;
+            auto* val = self.base().find(key);
+            if (!val)
+                throwKeyError(name);
+            return val->setByUser != 0;
+        }, py::arg("name"))
+
+        .def("get_special_value", [](const ConfigOverlay& self, const std::string& cat, py::handle name, py::object key) -> py::object {
+            std::string keyStr = key.is_none() ? std::string{} : key.cast<std::string>();
+            auto*       val    = self.base().findSpecial(cat, keyName(name), keyStr);
+            return val ? snapshotValueToPython(self.base(), *val) : py::none();
+        }, py::arg("category"), py::arg("name"), py::arg("key") = py::none())
+
+        .def("to_dict", [](const ConfigOverlay& self) {
+            const auto& base = self.base();
+            py::dict    result;
+            for (size_t i = 0; i < base.keyCount(); ++i) {
+                const auto name = base.keyName(i);
+                auto*      val  = self.findOverride(name);
+                setNested(result, name, val ? overlayValueToPython(*val) : snapshotValueToPython(base, base.valueAt(i)));
             }
+            return result;
+        })
+
+        .def_property_readonly("overrides", [](const ConfigOverlay& self) {
+            py::list result;
+            for (const auto& [name, val] : self.overrides())
+                result.append(py::str(name));
+            return result;
+        })
+
+        .def_property_readonly("base", [](const ConfigOverlay& self) { return self.overlayBase()->snapshot(); })
+
+        .def("__repr__", [](const ConfigOverlay& self) {
+            return "ConfigOverlay(overrides=" + std::to_string(self.overrides().size()) + ")";
+        });
+
+    py::class_<PyConfigRegistry>(m, "ConfigRegistry")
+        .def(py::init([](const std::vector<std::pair<std::string, py::object>>& schema, py::function loader, size_t maxBytes, size_t maxEntries, size_t shards) {
+            std::vector<SchemaEntry> entries;
+            entries.reserve(schema.size());
+            for (const auto& [name, defaultVal] : schema)
+                entries.push_back(schemaEntry(name, defaultVal));
+            return new PyConfigRegistry(std::move(entries), maxBytes, maxEntries, shards, std::move(loader));
+        }), py::arg("schema"), py::arg("loader"), py::arg("max_bytes") = 0, py::arg("max_entries") = 0, py::arg("shards") = 16)
+
+        // on a miss the loader is called with the GIL held and the config is
+        // parsed with it released
+        .def("get", [](PyConfigRegistry& self, const std::string& tenant) {
+            if (auto snap = self.find(tenant))
+                return snap;
+
+            py::object source   = self.loader(tenant);
+            const bool isStream = py::isinstance<py::bytes>(source);
+            const auto text     = isStream ? source.cast<std::string>() : py::str(source).cast<std::string>();
+
+            py::gil_scoped_release release;
+            return self.insert(tenant, self.load(text, isStream));
+        }, py::arg("tenant"))
+
+        .def("__contains__", &PyConfigRegistry::contains, py::arg("tenant"))
+        .def("invalidate", &PyConfigRegistry::erase, py::arg("tenant"))
+        .def("clear", &PyConfigRegistry::clear)
+        .def("__len__", [](const PyConfigRegistry& self) { return self.stats().entries; })
+
+        .def_property_readonly("stats", [](const PyConfigRegistry& self) {
+            auto     stats = self.stats();
+            py::dict result;
+            result["hits"]      = stats.hits;
+            result["misses"]    = stats.misses;
+            result["evictions"] = stats.evictions;
+            result["entries"]   = stats.entries;
+            result["nbytes"]    = stats.nbytes;
+            return result;
+        });
+
+    m.def("infer_schema", [](py::object text) {
+        PyBufferOwner                                  owner;
+        std::vector<std::pair<std::string, ValueType>> schema;
+        auto                                           view = textView(text, owner);
+        {
+            py::gil_scoped_release release;
+            schema = inferSchema(view);
+        }
+
+        py::list result(schema.size());
+        for (size_t i = 0; i < schema.size(); ++i) {
+            py::object defaultVal;
+            switch (schema[i].second) {
+                case ValueType::INT: defaultVal = py::int_(0); break;
+                case ValueType::FLOAT: defaultVal = py::float_(0.0); break;
+                case ValueType::VEC2: defaultVal = py::make_tuple(0.0, 0.0); break;
+                default: defaultVal = py::str(""); break;
+            }
+            result[i] = py::make_tuple(schema[i].first, defaultVal);
+        }
+        return result;
+    }, py::arg("text"));
+
+    py::class_<PyConfig>(m, "Config")
+        // bytes-like paths/streams are read in place; bytes and bytearray keep a
+        // trailing NUL and are handed to hyprlang without a copy
+        .def(py::init([](py::buffer data, const Hyprlang::SConfigOptions& opts, const ParseLimits& limits, bool sourceCache, std::optional<py::dict> variables) {
+            PyBufferOwner owner;
+            auto          text = textView(data, owner);
+            if (PyBytes_Check(data.ptr()) || PyByteArray_Check(data.ptr()))
+                return createConfig(text.data(), opts, limits, sourceCache, std::move(variables));
+            return createConfig(std::string{text}.c_str(), opts, limits, sourceCache, std::move(variables));
+        }), py::arg("path"), py::arg("options") = Hyprlang::SConfigOptions{}, py::arg("limits") = ParseLimits{}, py::arg("source_cache") = false,
+            py::arg("variables") = py::none())
+
+        .def(py::init([](const std::string& path, const Hyprlang::SConfigOptions& opts, const ParseLimits& limits, bool sourceCache, std::optional<py::dict> variables) {
+            return createConfig(path.c_str(), opts, limits, sourceCache, std::move(variables));
+        }), py::arg("path"), py::arg("options") = Hyprlang::SConfigOptions{}, py::arg("limits") = ParseLimits{}, py::arg("source_cache") = false,
+            py::arg("variables") = py::none())
+
+        .def_readonly("limits", &PyConfig::limits)
+
+        .def("add_value", [](PyConfig& self, const std::string& name, py::object defaultVal) {
+            auto entry = schemaEntry(name, defaultVal);
+            addSchemaEntry(self, entry);
+            self.keys.push_back({name, entry.type});
         }, py::arg("name"), py::arg("default_value"))
 
-        .def("commence", &Hyprlang::CConfig::commence)
+        .def("commence", [](PyConfig& self) {
+            self.commence();
+            for (auto& key : self.keys)
+                key.value = self.getConfigValuePtr(key.name.c_str());
+            self.index.build(self.keys);
+        })
+
+        // registered names, in registration order
+        .def("keys", [](const PyConfig& self) {
+            py::list result(self.keys.size());
+            for (size_t i = 0; i < self.keys.size(); ++i)
+                result[i] = py::str(self.keys[i].name);
+            return result;
+        })
+
+        .def("items", [](PyConfig& self) {
+            py::list result(self.keys.size());
+            for (size_t i = 0; i < self.keys.size(); ++i) {
+                const auto& key = self.keys[i];
+                auto*       ptr = key.value ? key.value : self.getConfigValuePtr(key.name.c_str());
+                result[i]       = py::make_tuple(key.name, ptr ? anyToPython(ptr->getValue()) : py::none());
+            }
+            return result;
+        })
+
+        // type tags as registered; no values are converted
+        .def("types", [](const PyConfig& self) {
+            py::dict result;
+            for (const auto& key : self.keys)
+                result[py::str(key.name)] = key.type;
+            return result;
+        })
+
+        // all registered values in one pass, as typed columns keyed by row
+        .def("export_columns", [](PyConfig& self) {
+            auto     columns = ValueColumns::collect(self, self.keys);
+
+            py::list keys(self.keys.size());
+            for (size_t i = 0; i < self.keys.size(); ++i)
+                keys[i] = py::str(self.keys[i].name);
+            py::list strings(columns.strings.size());
+            for (size_t i = 0; i < columns.strings.size(); ++i)
+                strings[i] = py::str(columns.strings[i]);
+
+            py::dict result;
+            result["keys"]        = keys;
+            result["set_by_user"] = py::bytes(reinterpret_cast<const char*>(columns.setByUser.data()), columns.setByUser.size());
+            result["int"]         = py::make_tuple(packedColumn(columns.intRows), packedColumn(columns.ints));
+            result["float"]       = py::make_tuple(packedColumn(columns.floatRows), packedColumn(columns.floats));
+            result["string"]      = py::make_tuple(packedColumn(columns.stringRows), strings);
+            result["vec2"]        = py::make_tuple(packedColumn(columns.vec2Rows), packedColumn(columns.vec2));
+            result["other"]       = packedColumn(columns.otherRows);
+            return result;
+        })
+
+        // values under one category, nested below it or flat by full name
+        .def("get_category", [](const PyConfig& self, const std::string& category, bool nested) {
+            const size_t strip = category.empty() || category.ends_with(':') ? category.size() : category.size() + 1;
+            py::dict     result;
+            for (const auto& entry : self.committedIndex().category(category)) {
+                auto value = anyToPython(entry.value->getValue());
+                if (nested)
+                    setNested(result, std::string_view{entry.name}.substr(strip), std::move(value));
+                else
+                    result[py::str(entry.name)] = std::move(value);
+            }
+            return result;
+        }, py::arg("category"), py::arg("nested") = true)
+
+        .def("get_matching", [](const PyConfig& self, const std::string& pattern) {
+            py::dict result;
+            for (const auto* entry : self.committedIndex().match(pattern))
+                result[py::str(entry->name)] = anyToPython(entry->value->getValue());
+            return result;
+        }, py::arg("pattern"))
 
-        .def("parse", &Hyprlang::CConfig::parse)
+        .def("parse", [](PyConfig& self) {
+            return self.runParse(self.root, self.rootIsStream, [&] { return self.parseRoot(); });
+        })
 
-        .def("parse_file", [](Hyprlang::CConfig& self, const std::string& path) {
-            return self.parseFile(path.c_str());
+        .def("parse_file", [](PyConfig& self, const std::string& path) {
+            return self.runParse(path, false, [&] { return self.parseFile(path.c_str()); });
         }, py::arg("path"))
 
-        .def("parse_dynamic", [](Hyprlang::CConfig& self, const std::string& line) {
-            return self.parseDynamic(line.c_str());
+        .def("parse_dynamic", [](PyConfig& self, const std::string& line) {
+            auto result       = self.parseDynamic(line.c_str());
+            auto [key, value] = splitDynamicLine(line);
+            // a line without '=' is recorded as a bare command
+            if (key.empty())
+                std::swap(key, value);
+            if (!result.error)
+                self.changes.markKey(key);
+            if (self.journal)
+                self.journal->record(key, value, !result.error, result.error ? result.getError() : "");
+            return result;
         }, py::arg("line"))
 
-        .def("parse_dynamic_kv", [](Hyprlang::CConfig& self, const std::string& command, const std::string& value) {
-            return self.parseDynamic(command.c_str(), value.c_str());
+        .def("parse_dynamic_kv", [](PyConfig& self, const std::string& command, const std::string& value) {
+            auto result = self.parseDynamic(command.c_str(), value.c_str());
+            if (!result.error)
+                self.changes.markKey(command);
+            if (self.journal)
+                self.journal->record(command, value, !result.error, result.error ? result.getError() : "");
+            return result;
         }, py::arg("command"), py::arg("value"))
 
-        .def("get_value", [](Hyprlang::CConfig& self, const std::string& name) -> py::object {
-            auto val = self.getConfigValue(name.c_str());
+        .def("enable_journal", [](PyConfig& self, size_t capacity) {
+            self.journal = capacity ? std::make_shared<ChangeJournal>(capacity) : nullptr;
+        }, py::arg("capacity"))
+
+        .def_property_readonly("journal", [](const PyConfig& self) { return self.journal; })
+
+        .def("set_variables", [](PyConfig& self, py::dict variables) {
+            if (!self.placeholderRoot)
+                throw std::runtime_error("set_variables() needs a config created with variables=");
+            std::vector<std::pair<std::string, std::string>> list;
+            for (auto [name, value] : variables)
+                list.emplace_back(py::str(name), py::str(value));
+            variableLines(list); // validates before anything is replaced
+            self.variables = std::move(list);
+        }, py::arg("variables"))
+
+        .def_property_readonly("variables", [](const PyConfig& self) {
+            py::dict result;
+            for (const auto& [name, value] : self.variables)
+                result[py::str(name)] = value;
+            return result;
+        })
+
+        .def("enable_prefetch", [](PyConfig& self, size_t threads) {
+            self.prefetchThreads = threads;
+        }, py::arg("threads") = 8)
+
+        .def_property_readonly("generation", [](const PyConfig& self) { return self.changes.generation(); })
+
+        .def("key_generation", [](const PyConfig& self, py::handle name) {
+            return self.changes.keyGeneration(keyName(name));
+        }, py::arg("name"))
+
+        // None when nothing changed (no objects are created), else
+        // (generation, keys) with keys None when everything must be re-read
+        .def("changes_since", [](const PyConfig& self, uint64_t token) -> py::object {
+            const auto generation = self.changes.generation();
+            if (token == generation)
+                return py::none();
+
+            auto keys = self.changes.changedSince(token);
+            if (!keys)
+                return py::make_tuple(generation, py::none());
+
+            py::list result(keys->size());
+            for (size_t i = 0; i < keys->size(); ++i)
+                result[i] = py::str((*keys)[i].data(), (*keys)[i].size());
+            return py::make_tuple(generation, result);
+        }, py::arg("token"))
+
+        .def("get_value", [](PyConfig& self, py::handle name) -> py::object {
+            auto val = self.getConfigValue(keyName(name));
             return anyToPython(val);
         }, py::arg("name"))
 
-        .def("get_value_info", [](Hyprlang::CConfig& self, const std::string& name) -> ConfigValueProxy {
-            auto* ptr = self.getConfigValuePtr(name.c_str());
+        .def("get_values", [](PyConfig& self, py::iterable names) {
+            py::list result;
+            for (auto name : names)
+                result.append(anyToPython(self.getConfigValue(keyName(name))));
+            return result;
+        }, py::arg("names"))
+
+        .def("value_descriptor", [](py::object self, py::handle name) {
+            const char* key = keyName(name);
+            auto*       ptr = self.cast<PyConfig&>().getConfigValuePtr(key);
             if (!ptr)
-                throw std::runtime_error("Config value not found: " + name);
+                throw std::runtime_error(std::string("Config value not found: ") + key);
+            auto* desc = reinterpret_cast<ValueDescriptorObject*>(valueDescriptorType->tp_alloc(valueDescriptorType, 0));
+            if (!desc)
+                throw py::error_already_set();
+            desc->config = self.release().ptr();
+            desc->value  = ptr;
+            return py::reinterpret_steal<py::object>(reinterpret_cast<PyObject*>(desc));
+        }, py::arg("name"))
+
+        .def("get_value_info", [](PyConfig& self, py::handle name) -> ConfigValueProxy {
+            const char* key = keyName(name);
+            auto*       ptr = self.getConfigValuePtr(key);
+            if (!ptr)
+                throw std::runtime_error(std::string("Config value not found: ") + key);
             return ConfigValueProxy{anyToPython(ptr->getValue()), ptr->m_bSetByUser};
         }, py::arg("name"))
 
-        .def("add_special_category", [](Hyprlang::CConfig& self, const std::string& name, Hyprlang::SSpecialCategoryOptions opts) {
+        .def("to_json", [](PyConfig& self, const std::vector<std::string>& keys, std::optional<int> indent, bool allowNan) {
+            return py::str(configToJson(self, keys, indent.value_or(-1), allowNan));
+        }, py::arg("keys"), py::arg("indent") = py::none(), py::kw_only(), py::arg("allow_nan") = false)
+
+        // every registered key, without a key list from Python
+        .def("to_json", [](PyConfig& self, std::optional<int> indent, bool allowNan) {
+            return py::str(configToJson(self, std::span<const KeyIndex::Entry>{self.keys}, indent.value_or(-1), allowNan));
+        }, py::arg("indent") = py::none(), py::kw_only(), py::arg("allow_nan") = false)
+
+        // values are read with the GIL held, like every other method touching
+        // the CConfig; hashing sources and building the image run without it
+        .def("snapshot", [](PyConfig& self, const std::vector<std::string>& keys, const std::vector<std::pair<std::string, std::string>>& specialValues,
+                            const std::vector<std::string>& sources) {
+            SnapshotBuilder builder;
+            addConfigValues(builder, self, keys, specialValues);
+            py::gil_scoped_release release;
+            return finishSnapshot(builder, sources);
+        }, py::arg("keys"), py::arg("special_values") = std::vector<std::pair<std::string, std::string>>{}, py::arg("sources") = std::vector<std::string>{})
+
+        .def("snapshot", [](PyConfig& self, const std::vector<std::pair<std::string, std::string>>& specialValues, const std::vector<std::string>& sources) {
+            SnapshotBuilder builder;
+            addConfigValues(builder, self, std::span<const KeyIndex::Entry>{self.keys}, specialValues);
+            py::gil_scoped_release release;
+            return finishSnapshot(builder, sources);
+        }, py::kw_only(), py::arg("special_values") = std::vector<std::pair<std::string, std::string>>{}, py::arg("sources") = std::vector<std::string>{})
+
+        .def("add_special_category", [](PyConfig& self, const std::string& name, Hyprlang::SSpecialCategoryOptions opts) {
             self.addSpecialCategory(name.c_str(), opts);
+            self.changes.markAll();
         }, py::arg("name"), py::arg("options") = Hyprlang::SSpecialCategoryOptions{})
 
-        .def("remove_special_category", [](Hyprlang::CConfig& self, const std::string& name) {
+        .def("remove_special_category", [](PyConfig& self, const std::string& name) {
             self.removeSpecialCategory(name.c_str());
+            self.changes.markAll();
         }, py::arg("name"))
 
-        .def("add_special_value", [](Hyprlang::CConfig& self, const std::string& cat, const std::string& name, py::object defaultVal) {
+        .def("add_special_value", [](PyConfig& self, const std::string& cat, const std::string& name, py::object defaultVal) {
             if (py::isinstance<py::int_>(defaultVal)) {
                 self.addSpecialConfigValue(cat.c_str(), name.c_str(), Hyprlang::CConfigValue((Hyprlang::INT)defaultVal.cast<int64_t>()));
             } else if (py::isinstance<py::float_>(defaultVal)) {
@@ -183,27 +1273,29 @@ PYBIND11_MODULE(_core, m) {
             } else {
                 throw std::invalid_argument("Unsupported default value type.");
             }
+            self.changes.markAll();
         }, py::arg("category"), py::arg("name"), py::arg("default_value"))
 
-        .def("remove_special_value", [](Hyprlang::CConfig& self, const std::string& cat, const std::string& name) {
+        .def("remove_special_value", [](PyConfig& self, const std::string& cat, const std::string& name) {
             self.removeSpecialConfigValue(cat.c_str(), name.c_str());
+            self.changes.markAll();
         }, py::arg("category"), py::arg("name"))
 
-        .def("get_special_value", [](Hyprlang::CConfig& self, const std::string& cat, const std::string& name, py::object key) -> py::object {
-            const char* keyPtr = key.is_none() ? nullptr : key.cast<std::string>().c_str();
-            auto val = self.getSpecialConfigValue(cat.c_str(), name.c_str(), keyPtr);
+        .def("get_special_value", [](PyConfig& self, const std::string& cat, py::handle name, py::object key) -> py::object {
+            std::string keyStr = key.is_none() ? std::string{} : key.cast<std::string>();
+            auto val = self.getSpecialConfigValue(cat.c_str(), keyName(name), key.is_none() ? nullptr : keyStr.c_str());
             return anyToPython(val);
         }, py::arg("category"), py::arg("name"), py::arg("key") = py::none())
 
-        .def("special_category_exists", [](Hyprlang::CConfig& self, const std::string& cat, const std::string& key) {
+        .def("special_category_exists", [](PyConfig& self, const std::string& cat, const std::string& key) {
             return self.specialCategoryExistsForKey(cat.c_str(), key.c_str());
         }, py::arg("category"), py::arg("key"))
 
-        .def("list_keys_for_special_category", [](Hyprlang::CConfig& self, const std::string& cat) {
+        .def("list_keys_for_special_category", [](PyConfig& self, const std::string& cat) {
             return self.listKeysForSpecialCategory(cat.c_str());
         }, py::arg("category"))
 
-        .def("register_handler", [](Hyprlang::CConfig& self, const std::string& name, py::function callback, Hyprlang::SHandlerOptions opts) {
+        .def("register_handler", [](PyConfig& self, const std::string& name, py::function callback, Hyprlang::SHandlerOptions opts) {
             auto cb = std::make_shared<py::function>(callback);
 
             auto trampoline = [cb](const char* command, const char* value) -> Hyprlang::CParseResult {
@@ -231,11 +1323,21 @@ PYBIND11_MODULE(_core, m) {
             );
         }, py::arg("name"), py::arg("callback"), py::arg("options") = Hyprlang::SHandlerOptions{})
 
-        .def("unregister_handler", [](Hyprlang::CConfig& self, const std::string& name) {
+        .def("unregister_handler", [](PyConfig& self, const std::string& name) {
             self.unregisterHandler(name.c_str());
         }, py::arg("name"))
 
-        .def("change_root_path", [](Hyprlang::CConfig& self, const std::string& path) {
-            self.changeRootPath(path.c_str());
+        .def("change_root_path", [](PyConfig& self, const std::string& path) {
+            // a placeholder-backed config hands hyprlang its root itself, and
+            // a stream root's text stays; only the base of its includes moves
+            if (!self.placeholderRoot)
+                self.changeRootPath(path.c_str());
+            if (!self.rootIsStream)
+                self.root = path;
+            else {
+                self.streamBase = path;
+                if (self.placeholderRoot && !self.useSourceCache)
+                    self.writeTemplate();
+            }
         }, py::arg("path"));
 }
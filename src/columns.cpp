@@ -0,0 +1,44 @@
+#include "columns.hpp"
+
+ValueColumns ValueColumns::collect(Hyprlang::CConfig& config, std::span<const KeyIndex::Entry> keys) {
+    ValueColumns out;
+    out.setByUser.assign((keys.size() + 7) / 8, 0);
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        const auto& key = keys[i];
+        auto*       ptr = key.value ? key.value : config.getConfigValuePtr(key.name.c_str());
+        const auto  row = static_cast<uint32_t>(i);
+        if (!ptr) {
+            out.otherRows.push_back(row);
+            continue;
+        }
+
+        if (ptr->m_bSetByUser)
+            out.setByUser[i / 8] |= static_cast<uint8_t>(1u << (i % 8));
+
+        const auto& val = ptr->getValue();
+        switch (valueTypeOf(val)) {
+            case ValueType::INT:
+                out.intRows.push_back(row);
+                out.ints.push_back(std::any_cast<int64_t>(val));
+                break;
+            case ValueType::FLOAT:
+                out.floatRows.push_back(row);
+                out.floats.push_back(std::any_cast<float>(val));
+                break;
+            case ValueType::STRING:
+                out.stringRows.push_back(row);
+                out.strings.push_back(std::any_cast<const char*>(val));
+                break;
+            case ValueType::VEC2: {
+                auto v = std::any_cast<Hyprlang::SVector2D>(val);
+                out.vec2Rows.push_back(row);
+                out.vec2.push_back(v.x);
+                out.vec2.push_back(v.y);
+                break;
+            }
+            default: out.otherRows.push_back(row); break;
+        }
+    }
+    return out;
+}
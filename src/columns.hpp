@@ -0,0 +1,25 @@
+#pragma once
+
+#include "keyindex.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Every registered value of a config split into one column per type, read in
+// a single pass for bulk export. Row numbers index the key list the columns
+// were collected from; each row lands in exactly one column.
+struct ValueColumns {
+    std::vector<uint32_t>    intRows, floatRows, stringRows, vec2Rows, otherRows;
+    std::vector<int64_t>     ints;
+    std::vector<float>       floats;
+    std::vector<const char*> strings; // owned by the config
+    std::vector<double>      vec2;    // x, y per row
+
+    // Bit i (LSB first within byte i / 8) is set when row i was set by the user.
+    std::vector<uint8_t>     setByUser;
+
+    // Reads `keys` from `config`, using each entry's value pointer when it is
+    // already resolved. Unknown names and custom values go to otherRows.
+    static ValueColumns      collect(Hyprlang::CConfig& config, std::span<const KeyIndex::Entry> keys);
+};
@@ -27,95 +27,124 @@ High-level (Pythonic):
 
 from __future__ import annotations
 
-from hyprlang_pybind._core import (
-    Config as _Config,
-    ConfigOptions,
-    ConfigValueProxy,
-    HandlerOptions,
-    ParseResult,
-    SpecialCategoryOptions,
-    SVector2D,
-)
+TYPE_CHECKING = False
+if TYPE_CHECKING:
+    from collections.abc import Callable, Iterable, Mapping
+    from os import PathLike
+    from types import ModuleType
+    from mmap import mmap
+    from typing import TextIO
+
+    from hyprlang_pybind._core import (
+        Bundle,
+        ChangeJournal,
+        Config as _Config,
+        ConfigOptions,
+        ConfigOverlay as _ConfigOverlay,
+        ConfigSnapshot,
+        ConfigValueProxy,
+        HandlerOptions,
+        OverlayBase,
+        ParseResult,
+        SharedConfig,
+        SpecialCategoryOptions,
+        SVector2D,
+        ValueType,
+    )
+
+# Names re-exported from _core. The extension is loaded on first use rather
+# than at import time, so short-lived tools that only import the package (or
+# fail early) do not pay for loading it.
+_LOW_LEVEL = frozenset({
+    "Bundle",
+    "ConfigOptions",
+    "ConfigSnapshot",
+    "ConfigValueProxy",
+    "HandlerOptions",
+    "ParseResult",
+    "SharedConfig",
+    "SpecialCategoryOptions",
+    "SVector2D",
+    "ValueType",
+})
+
+
+# The extension module once loaded. Functions reach native names through
+# _load_core() rather than importing them on every call.
+_native: ModuleType | None = None
+
+
+def _load_core() -> ModuleType:
+    global _native
+    if _native is None:
+        from hyprlang_pybind import _core
+
+        _native = _core
+    return _native
+
+
+def __getattr__(name: str) -> object:
+    if name in _LOW_LEVEL:
+        value = getattr(_load_core(), name)
+        globals()[name] = value
+        return value
+    raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
+
 
 __all__ = [
+    "Bundle",
     "ConfigOptions",
+    "ConfigSnapshot",
     "ConfigValueProxy",
     "HandlerOptions",
     "ParseResult",
+    "SharedConfig",
     "SpecialCategoryOptions",
     "SVector2D",
+    "ValueType",
     "Config",
     "parse_file",
     "parse_string",
+    "enable_parse_cache",
+    "disable_parse_cache",
+    "parse_cache_stats",
+    "load_compiled",
+    "bundle",
+    "layered",
+    "publish_shared",
+    "attach_shared",
+    "unlink_shared",
+    "source_cache_stats",
+    "set_source_cache_size",
+    "clear_source_cache",
+    "ConfigRegistry",
+    "ConfigOverlay",
+    "LiveConfig",
     "HyprlangError",
+    "HyprlangLimitError",
 ]
 
 type ConfigValue = int | float | str | tuple[float, float]
 
-_BOOL_WORDS = frozenset({"true", "false", "yes", "no", "on", "off"})
-_RE_INT = __import__("re").compile(r"^-?\d+$")
-_RE_HEX = __import__("re").compile(r"^0x[0-9a-fA-F]+$")
-_RE_FLOAT = __import__("re").compile(r"^-?\d*\.\d+$|^-?\d+\.\d*$")
-_RE_VEC2 = __import__("re").compile(r"^-?\d+\.?\d*\s+-?\d+\.?\d*$")
-_RE_COLOR = __import__("re").compile(r"^rgba?\(")
-
-
-def _infer_type(value: str) -> ConfigValue:
-    """Infer a hyprlang default from a raw value string."""
-    v = value.strip()
-    if v.lower() in _BOOL_WORDS:
-        return 0
-    if _RE_HEX.match(v) or _RE_INT.match(v):
-        return 0
-    if _RE_COLOR.match(v):
-        return 0
-    if _RE_FLOAT.match(v):
-        return 0.0
-    if _RE_VEC2.match(v):
-        return (0.0, 0.0)
-    return ""
-
-
-def _infer_schema(text: str) -> dict[str, ConfigValue]:
-    """Pre-scan hyprlang text and build a flat schema by inferring types."""
-    schema: dict[str, ConfigValue] = {}
-    category_stack: list[str] = []
-
-    for raw_line in text.splitlines():
-        line = raw_line.split("#")[0].strip()
-        if not line:
-            continue
-
-        if line.startswith("$") or line.startswith("source"):
-            continue
+type Buffer = bytes | bytearray | memoryview
+# A key name, either joined ("general:snap:enabled") or as a tuple path
+# (("general", "snap", "enabled")).
+type Key = str | tuple[str, ...]
 
-        if line.endswith("{"):
-            cat = line[:-1].strip().split("[")[0].strip()
-            if cat:
-                category_stack.append(cat)
-            continue
 
-        if line == "}":
-            if category_stack:
-                category_stack.pop()
-            continue
-
-        if "=" in line:
-            key, _, val = line.partition("=")
-            key = key.strip()
-            val = val.strip()
-            if not key or not val:
-                continue
-            full_key = ":".join([*category_stack, key])
-            schema[full_key] = _infer_type(val)
-
-    return schema
+def _infer_schema(text: str | Buffer) -> list[tuple[str, ConfigValue]]:
+    """Pre-scan hyprlang text and build a flat schema by inferring types."""
+    return _load_core().infer_schema(text)
 
 
 class HyprlangError(Exception):
     """Raised when hyprlang parsing fails."""
 
 
+class HyprlangLimitError(HyprlangError):
+    """Raised when a parse exceeds one of the Config's resource limits."""
+
+
 def _flatten_schema(
     schema: dict, prefix: str = ""
 ) -> list[tuple[str, ConfigValue]]:
@@ -144,26 +173,133 @@ def _unflatten(flat: dict[str, object]) -> dict[str, object]:
     return result
 
 
+def _attrs_conflict(name: str) -> HyprlangError:
+    return HyprlangError(
+        f"{name!r} is both a value and a category, so attrs cannot hold it; "
+        f"read it with config[{name!r}]"
+    )
+
+
+def _build_attrs(raw: _Config, keys: list[str]) -> object:
+    """Build the Config.attrs tree for the registered keys.
+
+    Every category becomes an instance of its own slotted class, with child
+    categories as plain class attributes and values as native descriptors that
+    hold the resolved CConfigValue.
+
+    Raises HyprlangError if a name is both a value and a category, e.g. "a"
+    and "a:b", since one attribute cannot be both.
+    """
+    tree: dict[str, object] = {}
+    for key in keys:
+        parts = key.split(":")
+        node = tree
+        for part in parts[:-1]:
+            child = node.setdefault(part, {})
+            if not isinstance(child, dict):
+                raise _attrs_conflict(child)
+            node = child
+        if isinstance(node.get(parts[-1]), dict):
+            raise _attrs_conflict(key)
+        node[parts[-1]] = key
+
+    def make(path: str, node: dict[str, object]) -> object:
+        namespace: dict[str, object] = {
+            "__slots__": (),
+            "__repr__": lambda self: f"<Config.attrs {path or '(root)'}>",
+            "__dir__": lambda self: list(node),
+        }
+        for name, child in node.items():
+            if isinstance(child, dict):
+                namespace[name] = make(f"{path}:{name}" if path else name, child)
+            else:
+                namespace[name] = raw.value_descriptor(child)
+        return type("ConfigAttrs", (), namespace)()
+
+    return make("", tree)
+
+
 class Config:
     """High-level Pythonic wrapper around hyprlang's CConfig."""
 
     def __init__(
         self,
-        path: str,
+        path: str | Buffer | mmap,
         *,
         verify_only: bool = False,
         throw_all_errors: bool = False,
         allow_missing_config: bool = False,
         is_stream: bool = False,
+        journal_size: int = 0,
+        max_bytes: int = 0,
+        max_include_depth: int = 0,
+        max_lines: int = 0,
+        timeout: float = 0.0,
+        prefetch: int = 0,
+        source_cache: bool = False,
+        variables: Mapping[str, object] | None = None,
     ) -> None:
-        opts = ConfigOptions()
+        core = _load_core()
+        opts = core.ConfigOptions()
         opts.verify_only = int(verify_only)
         opts.throw_all_errors = int(throw_all_errors)
         opts.allow_missing_config = int(allow_missing_config)
         opts.path_is_stream = int(is_stream)
-        self._config = _Config(path, opts)
-        self._keys: list[str] = []
+        limits = core.ParseLimits(
+            max_bytes=max_bytes,
+            max_include_depth=max_include_depth,
+            max_lines=max_lines,
+            timeout=timeout,
+        )
+        if variables is not None:
+            variables = {name: str(value) for name, value in variables.items()}
+        try:
+            self._config = core.Config(path, opts, limits, source_cache, variables)
+        except ValueError as e:
+            raise HyprlangError(str(e)) from e
+        if journal_size:
+            self._config.enable_journal(journal_size)
+        if prefetch:
+            self._config.enable_prefetch(prefetch)
+        self._special_values: list[tuple[str, str]] = []
+        self._sources: list[str] = [] if is_stream else [path]
         self._commenced = False
+        self._attrs: object | None = None
+        self._overlay_base: OverlayBase | None = None
+        self._bundle: Bundle | None = None
+
+    @classmethod
+    def from_bundle(cls, bundle: Bundle | str | Buffer, **options: object) -> Config:
+        """Create a Config that parses a bundle from bundle() as one stream.
+
+        bundle may also be the bundle's text, e.g. read back from a file.
+        Parse errors name the original file and line. Raises HyprlangError if
+        the text is not a bundle or fails its hash check.
+        """
+        native = _load_core().Bundle
+        if not isinstance(bundle, native):
+            try:
+                bundle = native.from_text(bundle)
+            except RuntimeError as e:
+                raise HyprlangError(str(e)) from e
+        config = cls(bundle.text, is_stream=True, **options)
+        config._bundle = bundle
+        return config
+
+    def set_variables(self, variables: Mapping[str, object]) -> None:
+        """Define hyprlang variables ($NAME) for the next parse().
+
+        Replaces any earlier set. The variables are defined natively ahead of
+        the config text, so one template can be parsed with different values
+        without rewriting it. The config must be created with variables= (an
+        empty dict will do) to accept them later.
+        """
+        try:
+            self._config.set_variables(
+                {name: str(value) for name, value in variables.items()}
+            )
+        except (ValueError, RuntimeError) as e:
+            raise HyprlangError(str(e)) from e
 
     def add(
         self,
@@ -174,7 +310,6 @@ class Config:
         if self._commenced:
             raise HyprlangError("Cannot add values after commence()")
         self._config.add_value(name, default)
-        self._keys.append(name)
 
     def add_special_category(
         self,
@@ -185,7 +320,7 @@ class Config:
         anonymous: bool = False,
     ) -> None:
         """Register a special (keyed/anonymous) category."""
-        opts = SpecialCategoryOptions()
+        opts = _load_core().SpecialCategoryOptions()
         if key is not None:
             opts.set_key(key)
         opts.ignore_missing = int(ignore_missing)
@@ -200,6 +335,7 @@ class Config:
     ) -> None:
         """Register a config value within a special category."""
         self._config.add_special_value(category, name, default)
+        self._special_values.append((category, name))
 
     def commence(self) -> None:
         """Lock the schema. No new values can be added after this."""
@@ -207,37 +343,62 @@ class Config:
         self._commenced = True
 
     def parse(self) -> None:
-        """Parse the config file. Raises HyprlangError on failure."""
-        result = self._config.parse()
+        """Parse the config file. Raises HyprlangError on failure.
+
+        Raises HyprlangLimitError if a resource limit is exceeded.
+        """
+        try:
+            result = self._config.parse()
+        except _load_core().LimitError as e:
+            raise HyprlangLimitError(str(e)) from None
+        finally:
+            self._overlay_base = None
         if result.error:
-            raise HyprlangError(result.error_message)
+            message = result.error_message
+            if self._bundle is not None and message:
+                message = self._bundle.annotate_error(message)
+            raise HyprlangError(message)
 
     def parse_dynamic(self, line: str) -> None:
         """Parse a single dynamic line. Raises HyprlangError on failure."""
         result = self._config.parse_dynamic(line)
+        self._overlay_base = None
         if result.error:
             raise HyprlangError(result.error_message)
 
     def parse_file(self, path: str) -> None:
-        """Parse an additional config file. Raises HyprlangError on failure."""
-        result = self._config.parse_file(path)
+        """Parse an additional config file. Raises HyprlangError on failure.
+
+        The file is checked against the same resource limits as the root.
+        """
+        try:
+            result = self._config.parse_file(path)
+        except _load_core().LimitError as e:
+            raise HyprlangLimitError(str(e)) from None
+        finally:
+            self._overlay_base = None
         if result.error:
             raise HyprlangError(result.error_message)
+        self._sources.append(path)
 
-    def get(self, name: str, default: object = None) -> ConfigValue | None:
+    def get(self, name: Key, default: object = None) -> ConfigValue | None:
         """Get a config value by name, returning default if not found."""
         val = self._config.get_value(name)
         if val is None:
             return default
         return val
 
+    def get_values(self, names: Iterable[Key]) -> list[ConfigValue | None]:
+        """Get several config values at once, with None for unknown names."""
+        return self._config.get_values(names)
+
     def get_special(
-        self, category: str, name: str, key: str | None = None
+        self, category: str, name: Key, key: str | None = None
     ) -> ConfigValue | None:
         """Get a special category config value."""
         return self._config.get_special_value(category, name, key)
 
-    def is_set_by_user(self, name: str) -> bool:
+    def is_set_by_user(self, name: Key) -> bool:
         """Check if a config value was explicitly set by the user."""
         info = self._config.get_value_info(name)
         return info.set_by_user
@@ -252,26 +413,289 @@ class Config:
 
     def to_dict(self) -> dict[str, object]:
         """Return all registered config values as a nested dict."""
-        flat = {}
-        for key in self._keys:
-            flat[key] = self._config.get_value(key)
-        return _unflatten(flat)
+        return _unflatten(dict(self._config.items()))
+
+    def keys(self) -> list[str]:
+        """Return the registered names in registration order.
+
+        Includes values registered directly on ``raw``.
+        """
+        return self._config.keys()
+
+    def items(self) -> list[tuple[str, ConfigValue]]:
+        """Return (name, value) pairs for every registered value."""
+        return self._config.items()
+
+    def types(self) -> dict[str, ValueType]:
+        """Return each registered name's type tag (INT, FLOAT, STRING, VEC2 or CUSTOM).
+
+        The tags are recorded at registration, so no value is read or converted.
+        """
+        return self._config.types()
+
+    def export_columns(self) -> dict[str, object]:
+        """Read every registered value and its set_by_user flag in one native pass.
+
+        Returns a dict with "keys" (registration order), "set_by_user" (bytes,
+        bit i of byte i // 8, least significant first, set when keys[i] was
+        set by the user) and one (rows, values) pair per type: "int", "float",
+        "string" and "vec2". rows and the numeric values are typed
+        memoryviews; vec2 values hold x, y per row. Rows that fit no column
+        are listed under "other".
+        """
+        return self._config.export_columns()
+
+    def get_category(
+        self, category: str, *, nested: bool = True
+    ) -> dict[str, object]:
+        """Return the values under one category, e.g. "decoration".
+
+        With nested, keys are relative to the category and split into dicts
+        like to_dict(); otherwise they are full names in a flat dict. Served
+        from a sorted key index built at commence(), so only the category's
+        keys are visited.
+        """
+        try:
+            return self._config.get_category(category, nested)
+        except RuntimeError as e:
+            raise HyprlangError(str(e)) from e
+
+    def get_matching(self, pattern: str) -> dict[str, object]:
+        """Return the values whose names match a glob such as "*:enabled".
+
+        Returns a flat dict keyed by full name. '*' also matches ':'.
+        """
+        try:
+            return self._config.get_matching(pattern)
+        except RuntimeError as e:
+            raise HyprlangError(str(e)) from e
+
+    def to_json(self, indent: int | None = None, *, allow_nan: bool = False) -> str:
+        """Serialize all registered values as nested JSON without building a dict.
+
+        Floats use the shortest form that round-trips the stored 32-bit value
+        (0.1 stays 0.1, where to_dict() gives 0.10000000149011612), vec2
+        values become two-element arrays and colors stay integers. NaN and
+        infinities raise ValueError unless allow_nan is set.
+        """
+        return self._config.to_json(indent, allow_nan=allow_nan)
+
+    def write_json(
+        self, file: TextIO, indent: int | None = None, *, allow_nan: bool = False
+    ) -> None:
+        """Write to_json() output to a text file object."""
+        file.write(self._config.to_json(indent, allow_nan=allow_nan))
+
+    def save_compiled(self, path: str) -> None:
+        """Write the parsed values to a binary snapshot readable by load_compiled().
 
-    def __getitem__(self, name: str) -> ConfigValue:
+        The snapshot records a hash of every source file, including files
+        pulled in through ``source =``, so stale snapshots can be detected.
+        """
+        snapshot = self._config.snapshot(
+            special_values=self._special_values, sources=self._sources
+        )
+        snapshot.save(path)
+
+    def snapshot(self) -> ConfigSnapshot:
+        """Freeze the current values into an immutable ConfigSnapshot.
+
+        Snapshots pickle as a single binary image (out-of-band with pickle
+        protocol 5), so they can be handed to multiprocessing workers.
+        """
+        return self._config.snapshot(special_values=self._special_values)
+
+    def __getitem__(self, name: Key) -> ConfigValue:
         val = self._config.get_value(name)
         if val is None:
             raise KeyError(name)
         return val
 
-    def __contains__(self, name: str) -> bool:
+    def __contains__(self, name: Key) -> bool:
         return self._config.get_value(name) is not None
 
+    @property
+    def generation(self) -> int:
+        """Counter bumped by every parse, parse_file, successful parse_dynamic
+        and special-category change, for cheap cache validation."""
+        return self._config.generation
+
+    def key_generation(self, name: Key) -> int:
+        """Generation of the last change that could have touched name.
+
+        A full parse or special-category change counts for every key; a
+        parse_dynamic counts only for its own key.
+        """
+        return self._config.key_generation(name)
+
+    def changes_since(self, token: int) -> tuple[int, list[str] | None] | None:
+        """Poll for changes since token, a previous generation.
+
+        Returns None if nothing changed. Otherwise returns (new_token, keys),
+        where keys lists each dynamically changed key once, most recent first,
+        or is None when the config was re-parsed (or too many changes happened)
+        since token and every key has to be re-read.
+        """
+        return self._config.changes_since(token)
+
+    @property
+    def journal(self) -> ChangeJournal | None:
+        """Journal of applied dynamic changes, or None unless journal_size was set.
+
+        journal.since(seq) returns the JournalEntry records (seq, command,
+        value, timestamp, ok, error) after seq, oldest first, or None if some
+        of them were already overwritten and the follower has to resync.
+        Replaying an entry is raw.parse_dynamic_kv(entry.command, entry.value).
+        """
+        return self._config.journal
+
+    def overlay(self) -> ConfigOverlay:
+        """Return a copy-on-write view of the current values.
+
+        The overlay stores only the keys changed through its parse_dynamic()
+        and reads every other key from a frozen snapshot shared by all
+        overlays of this config, taken on the first overlay() after each
+        parse. Later changes to this config are not seen by existing overlays.
+        """
+        if self._overlay_base is None:
+            self._overlay_base = _load_core().OverlayBase(self.snapshot())
+        return ConfigOverlay(self._overlay_base.overlay())
+
+    @property
+    def attrs(self) -> object:
+        """Attribute-style access to the registered values.
+
+        ``config.attrs.general.border_size`` reads the same value as
+        ``config["general:border_size"]`` but skips the name lookup: the tree is
+        built once, on first use after commence(), and every leaf holds the
+        resolved value. Names that are not identifiers are reachable with
+        getattr().
+        """
+        if not self._commenced:
+            raise HyprlangError("attrs is only available after commence()")
+        if self._attrs is None:
+            self._attrs = _build_attrs(self._config, self._config.keys())
+        return self._attrs
+
     @property
     def raw(self) -> _Config:
         """Access the underlying low-level Config object."""
         return self._config
 
 
+class ConfigOverlay:
+    """Copy-on-write view of a Config, returned by Config.overlay().
+
+    Overrides live in a small native map; every other key falls through to
+    the frozen base. Only regular keys can be overridden, and the values are
+    parsed without the base config's variables.
+    """
+
+    def __init__(self, overlay: _ConfigOverlay) -> None:
+        self._overlay = overlay
+
+    def parse_dynamic(self, line: str) -> None:
+        """Override a value with a ``key = value`` line. Raises HyprlangError on failure."""
+        result = self._overlay.parse_dynamic(line)
+        if result.error:
+            raise HyprlangError(result.error_message)
+
+    def get(self, name: Key, default: object = None) -> ConfigValue | None:
+        """Get a value by name, returning default if not found."""
+        val = self._overlay.get_value(name)
+        if val is None:
+            return default
+        return val
+
+    def get_values(self, names: Iterable[Key]) -> list[ConfigValue | None]:
+        """Get several values at once, with None for unknown names."""
+        return self._overlay.get_values(names)
+
+    def get_special(
+        self, category: str, name: Key, key: str | None = None
+    ) -> ConfigValue | None:
+        """Get a special category value from the base."""
+        return self._overlay.get_special_value(category, name, key)
+
+    def is_set_by_user(self, name: Key) -> bool:
+        """Whether the value is overridden here or was set in the base config."""
+        return self._overlay.is_set_by_user(name)
+
+    def to_dict(self) -> dict[str, object]:
+        """Return all values, overrides applied, as a nested dict."""
+        return self._overlay.to_dict()
+
+    @property
+    def overrides(self) -> list[str]:
+        """Names of the overridden keys, sorted."""
+        return self._overlay.overrides
+
+    @property
+    def base(self) -> ConfigSnapshot:
+        """The frozen snapshot this overlay falls through to."""
+        return self._overlay.base
+
+    @property
+    def raw(self) -> _ConfigOverlay:
+        """Access the underlying native overlay."""
+        return self._overlay
+
+    def __getitem__(self, name: Key) -> ConfigValue:
+        val = self._overlay.get_value(name)
+        if val is None:
+            raise KeyError(name)
+        return val
+
+    def __contains__(self, name: Key) -> bool:
+        return self._overlay.get_value(name) is not None
+
+
+def enable_parse_cache(
+    max_bytes: int = 64 << 20, *, max_entries: int | None = None
+) -> None:
+    """Cache parse_string() and parse_file() results process-wide.
+
+    Results are kept as immutable snapshots keyed by a hash of the text (or
+    the file's path, revalidated against its sources), the schema and the
+    options, and each call returns a fresh dict built from the snapshot. The
+    least recently used results are evicted past max_bytes or max_entries.
+    Calls with limits or variables always parse. Replaces any earlier cache.
+    """
+    _load_core().enable_parse_cache(max_bytes, max_entries or 0)
+
+
+def disable_parse_cache() -> None:
+    """Turn the parse cache off and drop its contents."""
+    _load_core().disable_parse_cache()
+
+
+def parse_cache_stats() -> dict[str, int] | None:
+    """Hit, miss and eviction counters plus entries and nbytes, or None when off."""
+    return _load_core().parse_cache_stats()
+
+
+def _parse_cached(
+    path: str | Buffer | mmap,
+    schema: dict | None,
+    is_stream: bool,
+    verify_only: bool,
+    throw_all_errors: bool,
+    allow_missing_config: bool,
+) -> dict[str, object] | None:
+    """Parse through the parse cache, or return None when it is off."""
+    core = _load_core()
+    opts = core.ConfigOptions()
+    opts.verify_only = int(verify_only)
+    opts.throw_all_errors = int(throw_all_errors)
+    opts.allow_missing_config = int(allow_missing_config)
+    flat_pairs = None if schema is None else _flatten_schema(schema)
+    try:
+        snapshot = core.parse_cached(path, flat_pairs, is_stream, opts)
+    except RuntimeError as e:
+        raise HyprlangError(str(e)) from e
+    return None if snapshot is None else snapshot.to_dict()
+
+
 def parse_file(
     path: str,
     schema: dict | None = None,
@@ -279,14 +703,30 @@ def parse_file(
     verify_only: bool = False,
     throw_all_errors: bool = False,
     allow_missing_config: bool = False,
+    max_bytes: int = 0,
+    max_include_depth: int = 0,
+    max_lines: int = 0,
+    timeout: float = 0.0,
+    prefetch: int = 0,
+    source_cache: bool = False,
+    variables: Mapping[str, object] | None = None,
 ) -> dict[str, object]:
     """Parse a hyprlang config file and return values as a nested dict.
 
-    If schema is None, the file is pre-scanned to infer keys and types.
+    If schema is None, the file is pre-scanned to infer keys and types; pass
+    a schema for untrusted files so the limits apply before anything is read.
+    Served from the parse cache when enable_parse_cache() was called.
     """
+    if not (max_bytes or max_include_depth or max_lines or timeout) and variables is None:
+        cached = _parse_cached(
+            path, schema, False, verify_only, throw_all_errors, allow_missing_config
+        )
+        if cached is not None:
+            return cached
+
     if schema is None:
-        with open(path) as f:
-            flat_pairs = list(_infer_schema(f.read()).items())
+        with open(path, "rb") as f:
+            flat_pairs = _infer_schema(f.read())
     else:
         flat_pairs = _flatten_schema(schema)
 
@@ -295,6 +735,13 @@ def parse_file(
         verify_only=verify_only,
         throw_all_errors=throw_all_errors,
         allow_missing_config=allow_missing_config,
+        max_bytes=max_bytes,
+        max_include_depth=max_include_depth,
+        max_lines=max_lines,
+        timeout=timeout,
+        prefetch=prefetch,
+        source_cache=source_cache,
+        variables=variables,
     )
     for key, default in flat_pairs:
         config.add(key, default)
@@ -304,18 +751,31 @@ def parse_file(
 
 
 def parse_string(
-    text: str,
+    text: str | Buffer | mmap,
     schema: dict | None = None,
     *,
     verify_only: bool = False,
     throw_all_errors: bool = False,
+    max_bytes: int = 0,
+    max_include_depth: int = 0,
+    max_lines: int = 0,
+    timeout: float = 0.0,
+    variables: Mapping[str, object] | None = None,
 ) -> dict[str, object]:
     """Parse a hyprlang config string and return values as a nested dict.
 
+    The text may be a str or any bytes-like object holding UTF-8 (bytes,
+    bytearray, memoryview, mmap); bytes and bytearray are parsed in place.
     If schema is None, the text is pre-scanned to infer keys and types.
+    Served from the parse cache when enable_parse_cache() was called.
     """
+    if not (max_bytes or max_include_depth or max_lines or timeout) and variables is None:
+        cached = _parse_cached(text, schema, True, verify_only, throw_all_errors, False)
+        if cached is not None:
+            return cached
+
     if schema is None:
-        flat_pairs = list(_infer_schema(text).items())
+        flat_pairs = _infer_schema(text)
     else:
         flat_pairs = _flatten_schema(schema)
 
@@ -324,9 +784,224 @@ def parse_string(
         verify_only=verify_only,
         throw_all_errors=throw_all_errors,
         is_stream=True,
+        max_bytes=max_bytes,
+        max_include_depth=max_include_depth,
+        max_lines=max_lines,
+        timeout=timeout,
+        variables=variables,
     )
     for key, default in flat_pairs:
         config.add(key, default)
     config.commence()
     config.parse()
     return config.to_dict()
+
+
+def load_compiled(path: str, *, validate: bool = True) -> ConfigSnapshot | None:
+    """Map a snapshot written by Config.save_compiled() without parsing.
+
+    Values are read straight from the mapped file. Returns None when validate
+    is set and a source file changed since the snapshot was written. Raises
+    HyprlangError if the file is not a valid snapshot.
+    """
+    try:
+        snapshot = _load_core().load_snapshot(path)
+    except RuntimeError as e:
+        raise HyprlangError(str(e)) from e
+    if validate and not snapshot.is_current():
+        return None
+    return snapshot
+
+
+def bundle(path: str) -> Bundle:
+    """Flatten a config and everything it sources into one Bundle.
+
+    bundle.text is self-contained hyprlang text with marker comments mapping
+    each line to its original file and line; write it out and load it with
+    Config.from_bundle() to parse without touching the source tree. Files are
+    read through the process-wide source cache, and a bundle built earlier for
+    the same path is returned as is while none of its inputs changed.
+    Raises HyprlangError if the root cannot be read or sources itself.
+    """
+    try:
+        return _load_core().bundle(path)
+    except RuntimeError as e:
+        raise HyprlangError(str(e)) from e
+
+
+def layered(
+    paths: list[str], schema: dict, *, allow_missing: bool = False
+) -> ConfigSnapshot:
+    """Parse config layers and merge them into one snapshot.
+
+    Later paths take precedence (e.g. system, site, user). Each key gets its
+    value from the highest layer that sets it, or the schema default when none
+    does; snapshot.origin(key) is the index of that layer in paths, or None.
+    The layers are parsed in parallel with the GIL released. With
+    allow_missing, absent files count as empty layers. Raises HyprlangError
+    naming the first layer that fails to parse.
+    """
+    try:
+        return _load_core().parse_layered(list(paths), _flatten_schema(schema), allow_missing)
+    except RuntimeError as e:
+        raise HyprlangError(str(e)) from e
+
+
+def publish_shared(name: str, config: Config | ConfigSnapshot) -> int:
+    """Publish a snapshot of config into POSIX shared memory under name.
+
+    Returns the new generation. Processes attached with attach_shared() pick
+    it up on their next lookup without re-parsing. Only one process should
+    publish under a given name.
+    """
+    snapshot = config.snapshot() if isinstance(config, Config) else config
+    try:
+        return _load_core().publish_shared(name, snapshot)
+    except RuntimeError as e:
+        raise HyprlangError(str(e)) from e
+
+
+def attach_shared(name: str) -> SharedConfig:
+    """Attach a read-only view of the snapshot published under name.
+
+    Lookups read the shared mapping directly and follow republished
+    generations automatically.
+    """
+    try:
+        return _load_core().SharedConfig(name)
+    except RuntimeError as e:
+        raise HyprlangError(str(e)) from e
+
+
+def unlink_shared(name: str) -> None:
+    """Remove the shared-memory segments published under name.
+
+    Views that are already attached keep working until they are dropped.
+    """
+    _load_core().unlink_shared(name)
+
+
+def source_cache_stats() -> dict[str, int]:
+    """Counters of the process-wide source cache used by Config(source_cache=True).
+
+    Keys: hits, misses, evictions, entries, nbytes and max_bytes.
+    """
+    return _load_core().source_cache_stats()
+
+
+def set_source_cache_size(max_bytes: int) -> None:
+    """Bound the process-wide source cache to max_bytes of file contents (0: unlimited)."""
+    _load_core().set_source_cache_size(max_bytes)
+
+
+def clear_source_cache() -> None:
+    """Drop every file held by the process-wide source cache."""
+    _load_core().clear_source_cache()
+
+
+class ConfigRegistry:
+    """Lazily loaded configs for many tenants sharing one schema.
+
+    loader(tenant) returns the tenant's config file path, or its config text
+    as bytes. Each config is parsed on first access, frozen into a
+    ConfigSnapshot and cached; the least recently used snapshots are evicted
+    once max_bytes (snapshot sizes) or max_entries is exceeded. Lookups are
+    spread over independently locked shards, and parsing runs with the GIL
+    released.
+    """
+
+    def __init__(
+        self,
+        schema: dict,
+        loader: Callable[[str], str | PathLike[str] | bytes],
+        *,
+        max_bytes: int | None = None,
+        max_entries: int | None = None,
+    ) -> None:
+        self._registry = _load_core().ConfigRegistry(
+            _flatten_schema(schema), loader, max_bytes or 0, max_entries or 0
+        )
+
+    def get(self, tenant: str) -> ConfigSnapshot:
+        """Return the tenant's snapshot, loading it on a miss.
+
+        Raises HyprlangError if the tenant's config fails to parse.
+        """
+        try:
+            return self._registry.get(tenant)
+        except RuntimeError as e:
+            raise HyprlangError(str(e)) from e
+
+    __getitem__ = get
+
+    def __contains__(self, tenant: str) -> bool:
+        """Whether the tenant is cached; does not load it."""
+        return tenant in self._registry
+
+    def __len__(self) -> int:
+        return len(self._registry)
+
+    def invalidate(self, tenant: str) -> bool:
+        """Drop the tenant's cached snapshot so the next access reloads it."""
+        return self._registry.invalidate(tenant)
+
+    def clear(self) -> None:
+        """Drop every cached snapshot. Counters are kept."""
+        self._registry.clear()
+
+    @property
+    def stats(self) -> dict[str, int]:
+        """Hit, miss and eviction counters plus current entries and nbytes."""
+        return self._registry.stats
+
+
+class LiveConfig:
+    """A config file that can be reloaded while other threads read it.
+
+    Readers go through the current immutable ConfigSnapshot, which is swapped
+    atomically: reload() parses the file into a new snapshot with the GIL
+    released and publishes it with one atomic store. A reader never sees a
+    partially applied reload and never waits for one; pin() returns the
+    current snapshot for a consistent view across several lookups.
+    """
+
+    def __init__(self, path: str, schema: dict | None = None) -> None:
+        self._path = path
+        self._schema = None if schema is None else _flatten_schema(schema)
+        self._live = _load_core().LiveSnapshot(self._build())
+
+    def _build(self) -> ConfigSnapshot:
+        schema = self._schema
+        try:
+            if schema is None:
+                with open(self._path, "rb") as f:
+                    schema = _infer_schema(f.read())
+            return _load_core().parse_snapshot(self._path, schema)
+        except (OSError, RuntimeError) as e:
+            raise HyprlangError(str(e)) from e
+
+    def reload(self) -> int:
+        """Re-parse the file and publish the result; returns the new version.
+
+        Raises HyprlangError and keeps the current version if parsing fails.
+        """
+        return self._live.publish(self._build())
+
+    def pin(self) -> ConfigSnapshot:
+        """The current snapshot, unaffected by later reloads."""
+        return self._live.current()
+
+    @property
+    def version(self) -> int:
+        """Number of published versions, starting at 1."""
+        return self._live.version
+
+    def get(self, name: Key, default: object = None) -> ConfigValue | None:
+        """Get a value from the current version, returning default if not found."""
+        return self._live.get(name, default)
+
+    def __getitem__(self, name: Key) -> ConfigValue:
+        return self._live[name]
+
+    def __contains__(self, name: Key) -> bool:
+        return name in self._live
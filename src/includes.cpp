@@ -0,0 +1,122 @@
+#include "includes.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <glob.h>
+#include <unordered_set>
+
+static std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+        s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r'))
+        s.remove_suffix(1);
+    return s;
+}
+
+std::string_view sourceDirectiveValue(std::string_view line) {
+    line = trim(line);
+    if (!line.starts_with("source"))
+        return {};
+
+    auto rest = trim(line.substr(6));
+    if (!rest.starts_with('='))
+        return {};
+    rest = rest.substr(1);
+
+    // a single # starts a comment, ## is an escaped literal
+    for (size_t i = 0; i < rest.size(); ++i) {
+        if (rest[i] != '#')
+            continue;
+        if (i + 1 < rest.size() && rest[i + 1] == '#') {
+            ++i;
+            continue;
+        }
+        rest = rest.substr(0, i);
+        break;
+    }
+
+    return trim(rest);
+}
+
+std::vector<std::string> resolveSourceDirective(std::string_view value, const std::string& includingFile) {
+    if (value.empty() || value.find('$') != std::string_view::npos)
+        return {};
+
+    std::string pattern{value};
+    if (pattern.starts_with('~')) {
+        const char* home = std::getenv("HOME");
+        if (!home)
+            return {};
+        pattern = home + pattern.substr(1);
+    }
+
+    if (!std::filesystem::path(pattern).is_absolute())
+        pattern = (std::filesystem::path(includingFile).parent_path() / pattern).string();
+
+    std::vector<std::string> result;
+    glob_t                   matches{};
+    if (glob(pattern.c_str(), GLOB_NOCHECK, nullptr, &matches) == 0) {
+        for (size_t i = 0; i < matches.gl_pathc; ++i)
+            result.emplace_back(matches.gl_pathv[i]);
+    }
+    globfree(&matches);
+    return result;
+}
+
+std::optional<std::string> absoluteSourceLine(std::string_view line, const std::string& includingFile) {
+    const auto value = sourceDirectiveValue(line);
+    if (value.empty() || value.find('$') != std::string_view::npos || value.starts_with('~') || std::filesystem::path(value).is_absolute())
+        return std::nullopt;
+
+    std::error_code ec;
+    auto            dir = std::filesystem::absolute(std::filesystem::path(includingFile).parent_path(), ec);
+    if (ec)
+        return std::nullopt;
+    return "source = " + (dir / value).string();
+}
+
+std::string absoluteSourceLines(std::string_view text, const std::string& includingFile) {
+    std::string out;
+    out.reserve(text.size());
+    while (!text.empty()) {
+        const auto end  = text.find('\n');
+        const auto line = text.substr(0, end);
+        const auto abs  = absoluteSourceLine(line, includingFile);
+        out.append(abs ? std::string_view{*abs} : line);
+        if (end == std::string_view::npos)
+            break;
+        out.push_back('\n');
+        text = text.substr(end + 1);
+    }
+    return out;
+}
+
+std::vector<std::string> collectSourceFiles(const std::vector<std::string>& roots) {
+    std::vector<std::string>        result;
+    std::unordered_set<std::string> seen;
+    std::vector<std::string>        pending(roots.rbegin(), roots.rend());
+
+    while (!pending.empty()) {
+        auto path = std::move(pending.back());
+        pending.pop_back();
+        if (!seen.insert(path).second)
+            continue;
+        result.push_back(path);
+
+        std::ifstream file(path);
+        if (!file)
+            continue;
+
+        // depth-first in source order, so the list follows parse order
+        std::vector<std::string> children;
+        std::string              line;
+        while (std::getline(file, line)) {
+            for (auto& child : resolveSourceDirective(sourceDirectiveValue(line), path))
+                children.push_back(std::move(child));
+        }
+        pending.insert(pending.end(), std::make_move_iterator(children.rbegin()), std::make_move_iterator(children.rend()));
+    }
+
+    return result;
+}
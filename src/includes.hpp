@@ -0,0 +1,29 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Returns the value of a `source = <path>` line with comments stripped, or an
+// empty view if the line is not a source directive.
+std::string_view sourceDirectiveValue(std::string_view line);
+
+// Resolves a source directive the way hyprlang does: `~` expands to $HOME,
+// relative paths are taken from the including file's directory and globs are
+// expanded. Values that reference variables cannot be resolved statically and
+// yield nothing.
+std::vector<std::string> resolveSourceDirective(std::string_view value, const std::string& includingFile);
+
+// For a source directive with a relative, variable-free value, the same
+// directive with the absolute path hyprlang would resolve from
+// `includingFile` (the working directory if empty), so the line means the
+// same when parsed from somewhere else. nullopt for any other line.
+std::optional<std::string> absoluteSourceLine(std::string_view line, const std::string& includingFile);
+
+// `text` with absoluteSourceLine() applied to each of its lines.
+std::string absoluteSourceLines(std::string_view text, const std::string& includingFile);
+
+// Every file reachable from `roots` through source directives, roots first,
+// each listed once. Unreadable files are listed but not followed.
+std::vector<std::string> collectSourceFiles(const std::vector<std::string>& roots);
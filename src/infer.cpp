@@ -0,0 +1,171 @@
+#include "infer.hpp"
+
+#include <unordered_map>
+
+static bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+static bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool isHexDigit(char c) {
+    return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+static std::string_view strip(std::string_view s) {
+    while (!s.empty() && isSpace(s.front()))
+        s.remove_prefix(1);
+    while (!s.empty() && isSpace(s.back()))
+        s.remove_suffix(1);
+    return s;
+}
+
+static bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        char c = a[i];
+        if (c >= 'A' && c <= 'Z')
+            c += 'a' - 'A';
+        if (c != b[i])
+            return false;
+    }
+    return true;
+}
+
+// Consumes `-?\d*` (or `-?\d+` when `required`) and returns the digit count, or
+// -1 if the required digits are missing.
+static int skipInteger(std::string_view& s, bool required) {
+    if (s.starts_with('-'))
+        s.remove_prefix(1);
+    int n = 0;
+    while (!s.empty() && isDigit(s.front())) {
+        s.remove_prefix(1);
+        ++n;
+    }
+    return required && n == 0 ? -1 : n;
+}
+
+static bool isInt(std::string_view s) {
+    return skipInteger(s, true) > 0 && s.empty();
+}
+
+static bool isHex(std::string_view s) {
+    if (!s.starts_with("0x") || s.size() == 2)
+        return false;
+    for (char c : s.substr(2)) {
+        if (!isHexDigit(c))
+            return false;
+    }
+    return true;
+}
+
+static bool isFloat(std::string_view s) {
+    // -?\d*\.\d+ | -?\d+\.\d*
+    const int before = skipInteger(s, false);
+    if (!s.starts_with('.'))
+        return false;
+    s.remove_prefix(1);
+    int after = 0;
+    while (!s.empty() && isDigit(s.front())) {
+        s.remove_prefix(1);
+        ++after;
+    }
+    return s.empty() && (before > 0 || after > 0);
+}
+
+// -?\d+\.?\d*
+static bool skipVecComponent(std::string_view& s) {
+    if (skipInteger(s, true) < 0)
+        return false;
+    if (s.starts_with('.'))
+        s.remove_prefix(1);
+    while (!s.empty() && isDigit(s.front()))
+        s.remove_prefix(1);
+    return true;
+}
+
+static bool isVec2(std::string_view s) {
+    if (!skipVecComponent(s) || s.empty() || !isSpace(s.front()))
+        return false;
+    while (!s.empty() && isSpace(s.front()))
+        s.remove_prefix(1);
+    return skipVecComponent(s) && s.empty();
+}
+
+static ValueType inferType(std::string_view v) {
+    for (auto word : {"true", "false", "yes", "no", "on", "off"}) {
+        if (iequals(v, word))
+            return ValueType::INT;
+    }
+    if (isHex(v) || isInt(v))
+        return ValueType::INT;
+    if (v.starts_with("rgb(") || v.starts_with("rgba("))
+        return ValueType::INT;
+    if (isFloat(v))
+        return ValueType::FLOAT;
+    if (isVec2(v))
+        return ValueType::VEC2;
+    return ValueType::STRING;
+}
+
+std::vector<std::pair<std::string, ValueType>> inferSchema(std::string_view text) {
+    std::vector<std::pair<std::string, ValueType>> schema;
+    std::unordered_map<std::string, size_t>         positions;
+    std::vector<std::string_view>                   categories;
+
+    while (!text.empty()) {
+        auto end = text.find_first_of("\r\n");
+        auto raw = text.substr(0, end);
+        if (end == std::string_view::npos)
+            text = {};
+        else
+            text.remove_prefix(end + (text.substr(end).starts_with("\r\n") ? 2 : 1));
+
+        auto line = strip(raw.substr(0, raw.find('#')));
+        if (line.empty() || line.starts_with('$') || line.starts_with("source"))
+            continue;
+
+        if (line.ends_with('{')) {
+            auto cat = strip(line.substr(0, line.size() - 1));
+            cat      = strip(cat.substr(0, cat.find('[')));
+            if (!cat.empty())
+                categories.push_back(cat);
+            continue;
+        }
+
+        if (line == "}") {
+            if (!categories.empty())
+                categories.pop_back();
+            continue;
+        }
+
+        const auto eq = line.find('=');
+        if (eq == std::string_view::npos)
+            continue;
+
+        const auto key = strip(line.substr(0, eq));
+        const auto val = strip(line.substr(eq + 1));
+        if (key.empty() || val.empty())
+            continue;
+
+        std::string fullKey;
+        for (auto cat : categories) {
+            fullKey.append(cat);
+            fullKey.push_back(':');
+        }
+        fullKey.append(key);
+
+        const auto type = inferType(val);
+        if (auto it = positions.find(fullKey); it != positions.end())
+            schema[it->second].second = type;
+        else {
+            positions.emplace(fullKey, schema.size());
+            schema.emplace_back(std::move(fullKey), type);
+        }
+    }
+
+    return schema;
+}
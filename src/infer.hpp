@@ -0,0 +1,15 @@
+#pragma once
+
+#include "values.hpp"
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Pre-scans hyprlang text and infers a flat schema: every `key = value` line
+// under its category path, with the type its value looks like (INT for
+// integers, hex, booleans and colors, FLOAT, VEC2 or STRING). Variables and
+// source directives are skipped. A repeated key keeps its first position and
+// the type of its last value.
+std::vector<std::pair<std::string, ValueType>> inferSchema(std::string_view text);
@@ -0,0 +1,45 @@
+#include "journal.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+ChangeJournal::ChangeJournal(size_t capacity) {
+    if (capacity == 0)
+        throw std::invalid_argument("Journal capacity must be positive");
+    m_entries.resize(capacity);
+}
+
+void ChangeJournal::record(std::string_view command, std::string_view value, bool ok, std::string_view error) {
+    const auto now   = std::chrono::system_clock::now().time_since_epoch();
+    auto&      entry = m_entries[++m_lastSeq % m_entries.size()];
+    entry.seq        = m_lastSeq;
+    entry.command.assign(command);
+    entry.value.assign(value);
+    entry.timestamp = std::chrono::duration<double>(now).count();
+    entry.ok        = ok;
+    entry.error.assign(error);
+}
+
+std::optional<std::vector<JournalEntry>> ChangeJournal::since(uint64_t seq) const {
+    const uint64_t first = m_lastSeq > m_entries.size() ? m_lastSeq - m_entries.size() + 1 : 1;
+    if (seq + 1 < first)
+        return std::nullopt;
+
+    std::vector<JournalEntry> result;
+    for (uint64_t s = std::max(seq + 1, first); s <= m_lastSeq; ++s)
+        result.push_back(m_entries[s % m_entries.size()]);
+    return result;
+}
+
+uint64_t ChangeJournal::lastSeq() const {
+    return m_lastSeq;
+}
+
+size_t ChangeJournal::size() const {
+    return std::min<uint64_t>(m_lastSeq, m_entries.size());
+}
+
+size_t ChangeJournal::capacity() const {
+    return m_entries.size();
+}
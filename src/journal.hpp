@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct JournalEntry {
+    uint64_t    seq = 0;
+    std::string command;
+    std::string value;
+    double      timestamp = 0; // seconds since the epoch
+    bool        ok        = true;
+    std::string error;
+};
+
+// Ring buffer of the last `capacity` dynamic changes applied to a config, for
+// followers that replay them. Sequence numbers start at 1 and never repeat.
+class ChangeJournal {
+  public:
+    explicit ChangeJournal(size_t capacity);
+
+    void                                     record(std::string_view command, std::string_view value, bool ok, std::string_view error);
+
+    // Entries after `seq`, oldest first. nullopt if some of them were already
+    // overwritten, in which case the follower has to resync.
+    std::optional<std::vector<JournalEntry>> since(uint64_t seq) const;
+
+    uint64_t                                 lastSeq() const;
+    size_t                                   size() const;
+    size_t                                   capacity() const;
+
+  private:
+    std::vector<JournalEntry> m_entries; // slot seq % capacity
+    uint64_t                  m_lastSeq = 0;
+};
@@ -0,0 +1,239 @@
+#include "json.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+struct JsonValue {
+    ValueType        type = ValueType::EMPTY;
+    int64_t          i    = 0;
+    float            f    = 0;
+    double           vec[2]{};
+    bool             vec32 = false; // vec holds widened 32-bit values (snapshots)
+    std::string_view str;
+};
+
+struct JsonEntry {
+    std::string_view name;
+    JsonValue        value;
+};
+
+struct JsonNode {
+    std::string_view                             name;
+    size_t                                       entry = 0; // 1-based index into the entries, 0 for none
+    std::vector<size_t>                          children;
+    std::unordered_map<std::string_view, size_t> index;
+};
+
+static void writeNewline(std::string& out, int indent, int depth) {
+    out += '\n';
+    out.append(static_cast<size_t>(indent) * depth, ' ');
+}
+
+static void writeString(std::string& out, std::string_view s) {
+    out += '"';
+    for (unsigned char c : s) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else
+                    out += static_cast<char>(c);
+        }
+    }
+    out += '"';
+}
+
+// Writes the shortest text that reads back as `f` at its own precision, so a
+// float is spelled at 32-bit precision (0.1, not 0.10000000149011612).
+template <typename T>
+static void writeFloat(std::string& out, T f, bool allowNan) {
+    if (!std::isfinite(f)) {
+        if (!allowNan)
+            throw std::invalid_argument("Out of range float values are not JSON compliant");
+        // same spelling as json.dumps
+        out += std::isnan(f) ? "NaN" : f < 0 ? "-Infinity" : "Infinity";
+        return;
+    }
+
+    char buf[32];
+    auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), f);
+    const std::string_view s(buf, end - buf);
+    out += s;
+    if (s.find_first_of(".e") == std::string_view::npos)
+        out += ".0";
+}
+
+static void writeValue(std::string& out, const JsonValue& val, int indent, int depth, bool allowNan) {
+    switch (val.type) {
+        case ValueType::INT: {
+            char buf[24];
+            auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), val.i);
+            out.append(buf, end - buf);
+            break;
+        }
+        case ValueType::FLOAT: writeFloat(out, val.f, allowNan); break;
+        case ValueType::STRING: writeString(out, val.str); break;
+        case ValueType::VEC2:
+            out += '[';
+            for (int i = 0; i < 2; ++i) {
+                if (i)
+                    out += indent < 0 ? ", " : ",";
+                if (indent >= 0)
+                    writeNewline(out, indent, depth + 1);
+                if (val.vec32)
+                    writeFloat(out, static_cast<float>(val.vec[i]), allowNan);
+                else
+                    writeFloat(out, val.vec[i], allowNan);
+            }
+            if (indent >= 0)
+                writeNewline(out, indent, depth);
+            out += ']';
+            break;
+        default: out += "null"; break;
+    }
+}
+
+static void writeNode(std::string& out, const std::vector<JsonNode>& nodes, const std::vector<JsonEntry>& entries, size_t n, int indent, int depth,
+                      bool allowNan) {
+    const auto& node = nodes[n];
+    if (n != 0 && node.children.empty()) {
+        if (node.entry)
+            writeValue(out, entries[node.entry - 1].value, indent, depth, allowNan);
+        else
+            out += "null";
+        return;
+    }
+
+    out += '{';
+    for (size_t i = 0; i < node.children.size(); ++i) {
+        if (i)
+            out += indent < 0 ? ", " : ",";
+        if (indent >= 0)
+            writeNewline(out, indent, depth + 1);
+        const auto child = node.children[i];
+        writeString(out, nodes[child].name);
+        out += ": ";
+        writeNode(out, nodes, entries, child, indent, depth + 1, allowNan);
+    }
+    if (indent >= 0 && !node.children.empty())
+        writeNewline(out, indent, depth);
+    out += '}';
+}
+
+static std::string writeJson(const std::vector<JsonEntry>& entries, int indent, bool allowNan) {
+    std::vector<JsonNode> nodes(1);
+
+    for (size_t e = 0; e < entries.size(); ++e) {
+        const auto name  = entries[e].name;
+        size_t     node  = 0;
+        size_t     start = 0;
+        while (true) {
+            const auto pos  = name.find(':', start);
+            const auto part = name.substr(start, pos == std::string_view::npos ? std::string_view::npos : pos - start);
+
+            size_t     child;
+            if (auto it = nodes[node].index.find(part); it != nodes[node].index.end())
+                child = it->second;
+            else {
+                child = nodes.size();
+                nodes.push_back(JsonNode{.name = part});
+                nodes[node].children.push_back(child);
+                nodes[node].index.emplace(part, child);
+            }
+
+            node = child;
+            if (pos == std::string_view::npos)
+                break;
+            start = pos + 1;
+        }
+        nodes[node].entry = e + 1;
+    }
+
+    std::string out;
+    out.reserve(entries.size() * 32);
+    writeNode(out, nodes, entries, 0, indent, 0, allowNan);
+    return out;
+}
+
+static JsonValue configJsonValue(const Hyprlang::CConfigValue* ptr) {
+    JsonValue value;
+    if (!ptr)
+        return value;
+
+    const auto val = ptr->getValue();
+    value.type     = valueTypeOf(val);
+    switch (value.type) {
+        case ValueType::INT: value.i = std::any_cast<int64_t>(val); break;
+        case ValueType::FLOAT: value.f = std::any_cast<float>(val); break;
+        case ValueType::STRING: {
+            const char* s = std::any_cast<const char*>(val);
+            value.str     = s ? s : "";
+            break;
+        }
+        case ValueType::VEC2: {
+            auto v       = std::any_cast<Hyprlang::SVector2D>(val);
+            value.vec[0] = v.x;
+            value.vec[1] = v.y;
+            value.vec32  = true; // hyprlang stores the components as float
+            break;
+        }
+        default: value.type = ValueType::EMPTY; break;
+    }
+    return value;
+}
+
+std::string configToJson(Hyprlang::CConfig& config, const std::vector<std::string>& keys, int indent, bool allowNan) {
+    std::vector<JsonEntry> entries;
+    entries.reserve(keys.size());
+    for (const auto& name : keys)
+        entries.push_back({.name = name, .value = configJsonValue(config.getConfigValuePtr(name.c_str()))});
+    return writeJson(entries, indent, allowNan);
+}
+
+std::string configToJson(Hyprlang::CConfig& config, std::span<const KeyIndex::Entry> keys, int indent, bool allowNan) {
+    std::vector<JsonEntry> entries;
+    entries.reserve(keys.size());
+    for (const auto& key : keys) {
+        auto* ptr = key.value ? key.value : config.getConfigValuePtr(key.name.c_str());
+        entries.push_back({.name = key.name, .value = configJsonValue(ptr)});
+    }
+    return writeJson(entries, indent, allowNan);
+}
+
+std::string snapshotToJson(const Snapshot& snapshot, int indent, bool allowNan) {
+    std::vector<JsonEntry> entries;
+    entries.reserve(snapshot.keyCount());
+
+    for (size_t i = 0; i < snapshot.keyCount(); ++i) {
+        const auto& val = snapshot.valueAt(i);
+        JsonEntry   entry{.name = snapshot.keyName(i)};
+        entry.value.type = val.type;
+        switch (val.type) {
+            case ValueType::INT: entry.value.i = val.data.i; break;
+            case ValueType::FLOAT: entry.value.f = val.data.f; break;
+            case ValueType::STRING: entry.value.str = snapshot.str(val.data.str); break;
+            case ValueType::VEC2:
+                entry.value.vec[0] = val.data.vec[0];
+                entry.value.vec[1] = val.data.vec[1];
+                entry.value.vec32  = true;
+                break;
+            default: entry.value.type = ValueType::EMPTY; break;
+        }
+        entries.push_back(entry);
+    }
+
+    return writeJson(entries, indent, allowNan);
+}
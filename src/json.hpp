@@ -0,0 +1,24 @@
+#pragma once
+
+#include "keyindex.hpp"
+#include "snapshot.hpp"
+
+#include <hyprlang.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+// JSON export of config values. Colon-separated keys become nested objects in
+// first-seen order, like to_dict(). Floats use the shortest representation
+// that round-trips to the stored 32-bit value (to_dict() widens them to
+// double instead), vec2 values are two-element arrays at the precision they
+// are stored with, and colors (stored as INT) are plain integers. Non-ASCII
+// text is written as UTF-8. `indent` < 0 gives single-line output; the
+// separators match json.dumps. Non-finite floats throw std::invalid_argument
+// unless `allowNan`, which writes them as json.dumps does.
+
+std::string configToJson(Hyprlang::CConfig& config, const std::vector<std::string>& keys, int indent, bool allowNan = false);
+// The same for registered keys, read through their value pointers when
+// already resolved.
+std::string configToJson(Hyprlang::CConfig& config, std::span<const KeyIndex::Entry> keys, int indent, bool allowNan = false);
+std::string snapshotToJson(const Snapshot& snapshot, int indent, bool allowNan = false);
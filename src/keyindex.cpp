@@ -0,0 +1,45 @@
+#include "keyindex.hpp"
+
+#include <algorithm>
+#include <fnmatch.h>
+
+void KeyIndex::build(std::vector<Entry> entries) {
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.name < b.name; });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.name == b.name; }), entries.end());
+    m_entries = std::move(entries);
+    m_built   = true;
+}
+
+bool KeyIndex::built() const {
+    return m_built;
+}
+
+const std::vector<KeyIndex::Entry>& KeyIndex::entries() const {
+    return m_entries;
+}
+
+std::span<const KeyIndex::Entry> KeyIndex::withPrefix(std::string_view prefix) const {
+    auto first = std::lower_bound(m_entries.begin(), m_entries.end(), prefix, [](const Entry& e, std::string_view p) { return std::string_view{e.name} < p; });
+    auto last  = first;
+    while (last != m_entries.end() && last->name.starts_with(prefix))
+        ++last;
+    return {first, last};
+}
+
+std::span<const KeyIndex::Entry> KeyIndex::category(std::string_view category) const {
+    std::string prefix{category};
+    if (!prefix.empty() && !prefix.ends_with(':'))
+        prefix.push_back(':');
+    return withPrefix(prefix);
+}
+
+std::vector<const KeyIndex::Entry*> KeyIndex::match(const std::string& pattern) const {
+    const auto                literal = std::string_view{pattern}.substr(0, pattern.find_first_of("*?[\\"));
+
+    std::vector<const Entry*> result;
+    for (const auto& entry : withPrefix(literal)) {
+        if (fnmatch(pattern.c_str(), entry.name.c_str(), 0) == 0)
+            result.push_back(&entry);
+    }
+    return result;
+}
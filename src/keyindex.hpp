@@ -0,0 +1,42 @@
+#pragma once
+
+#include "values.hpp"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The registered keys of a config in sorted order, built once at commence()
+// so category and pattern queries don't walk every value. Values are held by
+// pointer; hyprlang keeps them at stable addresses for the config's lifetime.
+class KeyIndex {
+  public:
+    struct Entry {
+        std::string             name;
+        ValueType               type  = ValueType::EMPTY; // as registered
+        Hyprlang::CConfigValue* value = nullptr;
+    };
+
+    // Replaces the index with `entries`, sorted by name. Later duplicates of
+    // a name are dropped.
+    void                      build(std::vector<Entry> entries);
+
+    bool                      built() const;
+    const std::vector<Entry>& entries() const;
+
+    // Entries under `category` (names starting with "category:"), found by
+    // binary search.
+    std::span<const Entry>    category(std::string_view category) const;
+
+    // Entries whose name matches the fnmatch(3) glob `pattern`, where '*'
+    // also matches ':'. The literal part of the pattern before its first
+    // wildcard narrows the scan by binary search.
+    std::vector<const Entry*> match(const std::string& pattern) const;
+
+  private:
+    std::span<const Entry>    withPrefix(std::string_view prefix) const;
+
+    std::vector<Entry>        m_entries;
+    bool                      m_built = false;
+};
@@ -0,0 +1,85 @@
+#include "layers.hpp"
+#include "includes.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+std::shared_ptr<Snapshot> parseLayered(const std::vector<std::string>& paths, const std::vector<SchemaEntry>& schema, bool allowMissing) {
+    if (paths.empty())
+        throw std::invalid_argument("layered() needs at least one path");
+    if (paths.size() > std::numeric_limits<uint16_t>::max())
+        throw std::invalid_argument("layered() supports at most 65535 layers");
+
+    std::vector<std::optional<Hyprlang::CConfig>> configs(paths.size());
+    std::vector<std::string>                      errors(paths.size());
+
+    auto parseLayer = [&](size_t i) {
+        try {
+            auto& config = configs[i].emplace(paths[i].c_str(), Hyprlang::SConfigOptions{.allowMissingConfig = allowMissing});
+            for (const auto& entry : schema)
+                addSchemaEntry(config, entry);
+            config.commence();
+
+            auto result = config.parse();
+            if (result.error)
+                errors[i] = result.getError();
+        } catch (const std::exception& e) {
+            errors[i] = e.what();
+        } catch (const char* e) {
+            // hyprlang throws C strings, e.g. "File does not exist"; nothing may
+            // escape a worker thread
+            errors[i] = e;
+        } catch (...) { errors[i] = "unknown error"; }
+    };
+
+    // each layer is an independent CConfig, so they parse concurrently on at
+    // most one worker per core, the calling thread included
+    std::atomic<size_t> next   = 0;
+    auto                worker = [&] {
+        for (size_t i = next++; i < paths.size(); i = next++)
+            parseLayer(i);
+    };
+
+    std::vector<std::jthread> pool;
+    const size_t              count = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), paths.size());
+    pool.reserve(count - 1);
+    for (size_t i = 1; i < count; ++i)
+        pool.emplace_back(worker);
+    worker();
+    pool.clear();
+
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (!errors[i].empty())
+            throw std::runtime_error("Layer " + paths[i] + ": " + errors[i]);
+    }
+
+    SnapshotBuilder builder;
+    for (const auto& entry : schema) {
+        const char*             name  = entry.name.c_str();
+        Hyprlang::CConfigValue* value = nullptr;
+        size_t                  layer = paths.size();
+        while (layer > 0) {
+            auto* ptr = configs[layer - 1]->getConfigValuePtr(name);
+            if (ptr && ptr->m_bSetByUser) {
+                value = ptr;
+                break;
+            }
+            --layer;
+        }
+
+        if (!value)
+            value = configs[0]->getConfigValuePtr(name);
+        if (value)
+            builder.addValue(entry.name, value->getValue(), layer != 0, static_cast<uint16_t>(layer));
+    }
+
+    for (const auto& path : collectSourceFiles(paths))
+        builder.addSource(path);
+
+    return Snapshot::fromBytes(builder.build());
+}
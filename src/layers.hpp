@@ -0,0 +1,15 @@
+#pragma once
+
+#include "snapshot.hpp"
+#include "values.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Parses each of `paths` against `schema` on its own thread and merges them
+// into one snapshot. Later paths are higher layers: every key takes its value
+// from the highest layer that set it, or the schema default if none did, and
+// records that layer (1-based) in SnapshotValue::layer. Sources of all layers
+// are recorded. Throws std::runtime_error naming the first layer that failed.
+std::shared_ptr<Snapshot> parseLayered(const std::vector<std::string>& paths, const std::vector<SchemaEntry>& schema, bool allowMissing);
@@ -0,0 +1,100 @@
+#include "limits.hpp"
+#include "includes.hpp"
+#include "sources.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <sys/stat.h>
+#include <vector>
+
+struct LimitScan {
+    const ParseLimits&                    limits;
+    std::chrono::steady_clock::time_point start;
+    size_t                                bytes = 0;
+    size_t                                lines = 0;
+    std::vector<std::string>              stack; // canonical paths being scanned
+};
+
+static void scanFile(LimitScan& scan, const std::string& path, size_t depth);
+
+static void scanBytes(LimitScan& scan, size_t n) {
+    scan.bytes += n;
+    if (scan.limits.maxBytes && scan.bytes > scan.limits.maxBytes)
+        throw LimitError("Config exceeds the limit of " + std::to_string(scan.limits.maxBytes) + " input bytes");
+}
+
+static void scanText(LimitScan& scan, std::string_view text, const std::string& file, size_t depth) {
+    size_t count = 0;
+    for (const char* p = text.data(); (p = static_cast<const char*>(std::memchr(p, '\n', text.data() + text.size() - p))); ++p)
+        ++count;
+    if (!text.empty() && text.back() != '\n')
+        ++count;
+
+    scan.lines += count;
+    if (scan.limits.maxLines && scan.lines > scan.limits.maxLines)
+        throw LimitError("Config exceeds the limit of " + std::to_string(scan.limits.maxLines) + " lines");
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        auto end  = text.find('\n', pos);
+        auto line = text.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+        pos       = end == std::string_view::npos ? text.size() : end + 1;
+
+        const auto value = sourceDirectiveValue(line);
+        if (value.empty())
+            continue;
+        const auto children = resolveSourceDirective(value, file);
+        // the parser would follow a path the scan cannot see, e.g. one built
+        // from a variable, past every limit
+        if (children.empty())
+            throw LimitError("Config sources a path that cannot be checked against the limits: " + std::string{value});
+        for (const auto& child : children)
+            scanFile(scan, child, depth + 1);
+    }
+}
+
+static void scanFile(LimitScan& scan, const std::string& path, size_t depth) {
+    checkParseDeadline(scan.limits, scan.start);
+    if (scan.limits.maxIncludeDepth && depth > scan.limits.maxIncludeDepth)
+        throw LimitError("Config exceeds the include depth limit of " + std::to_string(scan.limits.maxIncludeDepth) + " at " + path);
+
+    // missing or unreadable files are left for the parser to report
+    struct stat st{};
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+        return;
+    scanBytes(scan, st.st_size);
+
+    // the depth limit is optional, so loops need their own guard
+    auto canonical = canonicalPath(path);
+    if (std::ranges::find(scan.stack, canonical) != scan.stack.end())
+        throw LimitError("Config sources itself in a loop at " + path);
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return;
+    std::string text(st.st_size, '\0');
+    file.read(text.data(), text.size());
+    text.resize(file.gcount());
+
+    scan.stack.push_back(std::move(canonical));
+    scanText(scan, text, path, depth);
+    scan.stack.pop_back();
+}
+
+void checkParseDeadline(const ParseLimits& limits, std::chrono::steady_clock::time_point start) {
+    if (limits.timeout > 0 && std::chrono::steady_clock::now() - start > std::chrono::duration<double>(limits.timeout))
+        throw LimitError("Config parse exceeded its deadline of " + std::to_string(limits.timeout) + " s");
+}
+
+void checkParseLimits(const std::string& pathOrText, bool isStream, const ParseLimits& limits, std::chrono::steady_clock::time_point start) {
+    LimitScan scan{limits, start};
+    if (!isStream) {
+        scanFile(scan, pathOrText, 0);
+        return;
+    }
+
+    scanBytes(scan, pathOrText.size());
+    scanText(scan, pathOrText, "", 0);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+// Resource limits for parsing untrusted configs; 0 means unlimited. Input
+// bytes and lines are totals over the root and everything it sources, counted
+// again each time a file is sourced. Depth 1 is a file sourced by the root.
+struct ParseLimits {
+    size_t maxBytes        = 0;
+    size_t maxIncludeDepth = 0;
+    size_t maxLines        = 0;
+    double timeout         = 0; // seconds from the start of the parse
+
+    bool   any() const {
+        return maxBytes || maxIncludeDepth || maxLines || timeout > 0;
+    }
+};
+
+class LimitError : public std::runtime_error {
+  public:
+    using std::runtime_error::runtime_error;
+};
+
+// Walks the root and its source directives the way the parser will, and
+// throws LimitError as soon as a limit is exceeded, or when a file sources
+// itself directly or indirectly. File sizes are checked before a file is
+// read, so an oversized input is rejected without reading it. A source
+// directive that cannot be resolved statically (see resolveSourceDirective),
+// such as one using a variable, is rejected as well.
+void checkParseLimits(const std::string& pathOrText, bool isStream, const ParseLimits& limits, std::chrono::steady_clock::time_point start);
+
+// Throws LimitError if the timeout has passed since `start`.
+void checkParseDeadline(const ParseLimits& limits, std::chrono::steady_clock::time_point start);
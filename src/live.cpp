@@ -0,0 +1,30 @@
+#include "live.hpp"
+
+#include <stdexcept>
+
+static std::shared_ptr<Snapshot> requireSnapshot(std::shared_ptr<Snapshot> snapshot) {
+    if (!snapshot)
+        throw std::invalid_argument("LiveSnapshot needs a snapshot, not None");
+    return snapshot;
+}
+
+LiveSnapshot::LiveSnapshot(std::shared_ptr<Snapshot> initial) : m_current(requireSnapshot(std::move(initial))) {}
+
+std::shared_ptr<Snapshot> LiveSnapshot::current() const {
+    return m_current.load(std::memory_order_acquire);
+}
+
+uint64_t LiveSnapshot::version() const {
+    return m_version.load(std::memory_order_acquire);
+}
+
+uint64_t LiveSnapshot::publish(std::shared_ptr<Snapshot> next) {
+    next = requireSnapshot(std::move(next));
+
+    // version first: a reader that sees `next` then sees its version or a
+    // later one, never the one before
+    std::scoped_lock lock(m_publish);
+    const auto       version = m_version.fetch_add(1, std::memory_order_acq_rel) + 1;
+    m_current.store(std::move(next), std::memory_order_release);
+    return version;
+}
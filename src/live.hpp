@@ -0,0 +1,37 @@
+#pragma once
+
+#include "snapshot.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// The current version of a config, swapped RCU-style. Readers load the
+// shared_ptr atomically and keep using the snapshot they pinned for as long
+// as they hold it; a writer builds the next snapshot elsewhere and publishes
+// it with a single atomic store. Readers never see a partial reload and never
+// wait for a parse, but the load is not lock-free everywhere: libstdc++ guards
+// atomic<shared_ptr> with a spin-lock bit, so a read can spin for the few
+// instructions of a concurrent load or store. The old snapshot is freed once
+// its last reader lets go.
+class LiveSnapshot {
+  public:
+    // Throws std::invalid_argument if `initial` is null.
+    explicit LiveSnapshot(std::shared_ptr<Snapshot> initial);
+
+    std::shared_ptr<Snapshot> current() const;
+
+    // Number of snapshots published so far, the initial one included. Bumped
+    // before the snapshot is swapped in, so it never trails current().
+    uint64_t                  version() const;
+
+    // Makes `next` current and returns its version. Throws
+    // std::invalid_argument if `next` is null.
+    uint64_t                  publish(std::shared_ptr<Snapshot> next);
+
+  private:
+    std::atomic<std::shared_ptr<Snapshot>> m_current;
+    std::atomic<uint64_t>                  m_version = 1;
+    std::mutex                             m_publish; // orders concurrent writers; readers never take it
+};
@@ -0,0 +1,115 @@
+#include "overlay.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+static std::string_view strip(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+        s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r' || s.back() == '\n'))
+        s.remove_suffix(1);
+    return s;
+}
+
+OverlayBase::OverlayBase(std::shared_ptr<Snapshot> snapshot) : m_snapshot(std::move(snapshot)) {
+    if (!m_snapshot)
+        throw std::invalid_argument("OverlayBase needs a snapshot, not None");
+}
+
+const std::shared_ptr<Snapshot>& OverlayBase::snapshot() const {
+    return m_snapshot;
+}
+
+Hyprlang::CParseResult OverlayBase::parse(const std::string& key, const std::string& value, OverlayValue& out) {
+    std::scoped_lock lock(m_mutex);
+
+    if (!m_scratch) {
+        auto scratch = std::make_unique<Hyprlang::CConfig>("", Hyprlang::SConfigOptions{.pathIsStream = true});
+        for (size_t i = 0; i < m_snapshot->keyCount(); ++i) {
+            const auto& val = m_snapshot->valueAt(i);
+            if (val.type == ValueType::EMPTY || val.type == ValueType::CUSTOM)
+                continue;
+            addSchemaEntry(*scratch, SchemaEntry{.name = std::string{m_snapshot->keyName(i)}, .type = val.type});
+        }
+        scratch->commence();
+        scratch->parse();
+        m_scratch = std::move(scratch);
+    }
+
+    auto result = m_scratch->parseDynamic(key.c_str(), value.c_str());
+    if (result.error)
+        return result;
+
+    auto* ptr = m_scratch->getConfigValuePtr(key.c_str());
+    if (!ptr) {
+        result.setError(("config option <" + key + "> does not exist.").c_str());
+        return result;
+    }
+
+    const auto val = ptr->getValue();
+    out            = OverlayValue{.type = valueTypeOf(val)};
+    switch (out.type) {
+        case ValueType::INT: out.i = std::any_cast<int64_t>(val); break;
+        case ValueType::FLOAT: out.f = std::any_cast<float>(val); break;
+        case ValueType::STRING: {
+            const char* s = std::any_cast<const char*>(val);
+            out.str       = s ? s : "";
+            break;
+        }
+        case ValueType::VEC2: {
+            auto v     = std::any_cast<Hyprlang::SVector2D>(val);
+            out.vec[0] = v.x;
+            out.vec[1] = v.y;
+            break;
+        }
+        default: out.type = ValueType::EMPTY; break;
+    }
+    return result;
+}
+
+//
+
+ConfigOverlay::ConfigOverlay(std::shared_ptr<OverlayBase> base) : m_base(std::move(base)) {}
+
+Hyprlang::CParseResult ConfigOverlay::parseDynamic(std::string_view line) {
+    const auto eq = line.find('=');
+    if (eq == std::string_view::npos) {
+        Hyprlang::CParseResult result;
+        result.setError("Invalid dynamic line, expected key = value");
+        return result;
+    }
+    return parseDynamic(std::string{strip(line.substr(0, eq))}, std::string{strip(line.substr(eq + 1))});
+}
+
+Hyprlang::CParseResult ConfigOverlay::parseDynamic(const std::string& key, const std::string& value) {
+    OverlayValue parsed;
+    auto         result = m_base->parse(key, value, parsed);
+    if (result.error)
+        return result;
+
+    auto it = std::lower_bound(m_overrides.begin(), m_overrides.end(), key, [](const auto& o, const std::string& k) { return o.first < k; });
+    if (it != m_overrides.end() && it->first == key)
+        it->second = std::move(parsed);
+    else
+        m_overrides.emplace(it, key, std::move(parsed));
+    return result;
+}
+
+const OverlayValue* ConfigOverlay::findOverride(std::string_view name) const {
+    auto it = std::lower_bound(m_overrides.begin(), m_overrides.end(), name, [](const auto& o, std::string_view n) { return o.first < n; });
+    if (it == m_overrides.end() || it->first != name)
+        return nullptr;
+    return &it->second;
+}
+
+const Snapshot& ConfigOverlay::base() const {
+    return *m_base->snapshot();
+}
+
+const std::shared_ptr<OverlayBase>& ConfigOverlay::overlayBase() const {
+    return m_base;
+}
+
+const std::vector<std::pair<std::string, OverlayValue>>& ConfigOverlay::overrides() const {
+    return m_overrides;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "snapshot.hpp"
+
+#include <hyprlang.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Copy-on-write views of a frozen snapshot. A ConfigOverlay keeps only the
+// values it overrides, in a small vector sorted by name, and reads every other
+// key from the shared base, so an overlay costs memory in proportion to its
+// overrides. Overrides are parsed by a scratch CConfig that every overlay of a
+// base shares. It registers the base's keys with their types, so values go
+// through hyprlang's own parsing (colors, booleans, expressions), but it does
+// not know the base config's variables or special categories.
+
+struct OverlayValue {
+    ValueType   type = ValueType::EMPTY;
+    int64_t     i    = 0;
+    float       f    = 0;
+    float       vec[2]{};
+    std::string str;
+};
+
+class OverlayBase {
+  public:
+    // Throws std::invalid_argument if `snapshot` is null.
+    explicit OverlayBase(std::shared_ptr<Snapshot> snapshot);
+
+    const std::shared_ptr<Snapshot>& snapshot() const;
+
+    // Parses `value` for `key` with the scratch config and stores the result
+    // in `out`. Serialized across all overlays of this base.
+    Hyprlang::CParseResult parse(const std::string& key, const std::string& value, OverlayValue& out);
+
+  private:
+    std::shared_ptr<Snapshot>          m_snapshot;
+    std::mutex                         m_mutex;
+    std::unique_ptr<Hyprlang::CConfig> m_scratch; // built on the first parse
+};
+
+class ConfigOverlay {
+  public:
+    explicit ConfigOverlay(std::shared_ptr<OverlayBase> base);
+
+    // `key = value`, as accepted by CConfig::parseDynamic for regular keys.
+    Hyprlang::CParseResult                                   parseDynamic(std::string_view line);
+    Hyprlang::CParseResult                                   parseDynamic(const std::string& key, const std::string& value);
+
+    const OverlayValue*                                      findOverride(std::string_view name) const;
+    const Snapshot&                                          base() const;
+    const std::shared_ptr<OverlayBase>&                      overlayBase() const;
+    const std::vector<std::pair<std::string, OverlayValue>>& overrides() const;
+
+  private:
+    std::shared_ptr<OverlayBase>                      m_base;
+    std::vector<std::pair<std::string, OverlayValue>> m_overrides;
+};
@@ -0,0 +1,98 @@
+#include "prefetch.hpp"
+#include "includes.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <fcntl.h>
+#include <string_view>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_set>
+
+// Reads `path` in full and returns its size, or -1 if it cannot be read.
+static ssize_t readWhole(const std::string& path, std::string& out) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return -1;
+    }
+
+    // ask for the whole file up front instead of page-by-page readahead
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+
+    out.resize(st.st_size);
+    size_t done = 0;
+    while (done < out.size()) {
+        const ssize_t n = read(fd, out.data() + done, out.size() - done);
+        if (n <= 0)
+            break;
+        done += n;
+    }
+    close(fd);
+    out.resize(done);
+    return static_cast<ssize_t>(done);
+}
+
+PrefetchStats prefetchSourceFiles(const std::vector<std::string>& roots, size_t threads) {
+    PrefetchStats                   stats;
+    std::unordered_set<std::string> seen;
+    std::vector<std::string>        level;
+    for (const auto& root : roots) {
+        if (seen.insert(root).second)
+            level.push_back(root);
+    }
+
+    threads = std::max<size_t>(threads, 1);
+    while (!level.empty()) {
+        std::vector<std::vector<std::string>> children(level.size());
+        std::atomic<size_t>                   next  = 0;
+        std::atomic<size_t>                   files = 0;
+        std::atomic<size_t>                   bytes = 0;
+
+        auto worker = [&] {
+            std::string text;
+            for (size_t i = next++; i < level.size(); i = next++) {
+                const auto size = readWhole(level[i], text);
+                if (size < 0)
+                    continue;
+                ++files;
+                bytes += size;
+
+                std::string_view rest = text;
+                while (!rest.empty()) {
+                    const auto end = rest.find('\n');
+                    for (auto& child : resolveSourceDirective(sourceDirectiveValue(rest.substr(0, end)), level[i]))
+                        children[i].push_back(std::move(child));
+                    rest = end == std::string_view::npos ? std::string_view{} : rest.substr(end + 1);
+                }
+            }
+        };
+
+        std::vector<std::jthread> pool;
+        const size_t              count = std::min(threads, level.size());
+        pool.reserve(count - 1);
+        for (size_t i = 1; i < count; ++i)
+            pool.emplace_back(worker);
+        worker();
+        pool.clear();
+
+        stats.files += files;
+        stats.bytes += bytes;
+
+        std::vector<std::string> nextLevel;
+        for (auto& list : children) {
+            for (auto& child : list) {
+                if (seen.insert(child).second)
+                    nextLevel.push_back(std::move(child));
+            }
+        }
+        level = std::move(nextLevel);
+    }
+
+    return stats;
+}
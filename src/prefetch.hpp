@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct PrefetchStats {
+    size_t files = 0;
+    size_t bytes = 0;
+};
+
+// Reads every file reachable from `roots` through source directives ahead of
+// a parse, so hyprlang's own reads are served from the page cache. The graph
+// is walked one include level at a time and the files of a level are read
+// concurrently by up to `threads` threads; a chain of single includes still
+// costs one round trip per level. Unreadable files are skipped and left for
+// the parser to report.
+PrefetchStats prefetchSourceFiles(const std::vector<std::string>& roots, size_t threads);
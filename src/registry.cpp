@@ -0,0 +1,244 @@
+#include "registry.hpp"
+#include "includes.hpp"
+#include "infer.hpp"
+#include "sources.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <stdexcept>
+#include <unistd.h>
+
+SnapshotCache::SnapshotCache(size_t maxBytes, size_t maxEntries, size_t shards) {
+    // never more shards than entries, or a small entry budget could not be met
+    shards = std::max<size_t>(1, maxEntries ? std::min(shards, maxEntries) : shards);
+
+    // the first `total % shards` shards take one more unit than the rest
+    const auto share = [shards](size_t total, size_t i) { return total / shards + (i < total % shards ? 1 : 0); };
+
+    m_shards.reserve(shards);
+    for (size_t i = 0; i < shards; ++i) {
+        auto shard        = std::make_unique<Shard>();
+        shard->maxBytes   = maxBytes ? std::max<size_t>(1, share(maxBytes, i)) : 0;
+        shard->maxEntries = maxEntries ? share(maxEntries, i) : 0;
+        m_shards.push_back(std::move(shard));
+    }
+}
+
+SnapshotCache::Shard& SnapshotCache::shardFor(const std::string& key) const {
+    return *m_shards[std::hash<std::string>{}(key) % m_shards.size()];
+}
+
+size_t SnapshotCache::Entry::nbytes() const {
+    return snapshot->nbytes() + input.size();
+}
+
+std::shared_ptr<Snapshot> SnapshotCache::find(const std::string& key, std::string_view input) {
+    auto&            shard = shardFor(key);
+    std::scoped_lock lock(shard.mutex);
+
+    auto             it = shard.index.find(key);
+    if (it == shard.index.end() || it->second->input != input) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return it->second->snapshot;
+}
+
+std::shared_ptr<Snapshot> SnapshotCache::insert(const std::string& key, std::shared_ptr<Snapshot> snapshot, std::string input) {
+    auto&            shard = shardFor(key);
+    std::scoped_lock lock(shard.mutex);
+
+    if (auto it = shard.index.find(key); it != shard.index.end()) {
+        if (it->second->input == input) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            return it->second->snapshot;
+        }
+        // a different input under the same key replaces the entry
+        shard.nbytes -= it->second->nbytes();
+        shard.lru.erase(it->second);
+        shard.index.erase(it);
+    }
+
+    shard.lru.push_front(Entry{key, std::move(input), std::move(snapshot)});
+    shard.nbytes += shard.lru.front().nbytes();
+    shard.index.emplace(key, shard.lru.begin());
+
+    while (shard.lru.size() > 1 && ((shard.maxEntries && shard.lru.size() > shard.maxEntries) || (shard.maxBytes && shard.nbytes > shard.maxBytes))) {
+        auto& victim = shard.lru.back();
+        shard.nbytes -= victim.nbytes();
+        shard.index.erase(victim.key);
+        shard.lru.pop_back();
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return shard.lru.front().snapshot;
+}
+
+bool SnapshotCache::contains(const std::string& key) const {
+    auto&            shard = shardFor(key);
+    std::scoped_lock lock(shard.mutex);
+    return shard.index.contains(key);
+}
+
+bool SnapshotCache::erase(const std::string& key) {
+    auto&            shard = shardFor(key);
+    std::scoped_lock lock(shard.mutex);
+
+    auto             it = shard.index.find(key);
+    if (it == shard.index.end())
+        return false;
+
+    shard.nbytes -= it->second->nbytes();
+    shard.lru.erase(it->second);
+    shard.index.erase(it);
+    return true;
+}
+
+void SnapshotCache::clear() {
+    for (auto& shard : m_shards) {
+        std::scoped_lock lock(shard->mutex);
+        shard->lru.clear();
+        shard->index.clear();
+        shard->nbytes = 0;
+    }
+}
+
+SnapshotCacheStats SnapshotCache::stats() const {
+    SnapshotCacheStats stats{
+        .hits      = m_hits.load(std::memory_order_relaxed),
+        .misses    = m_misses.load(std::memory_order_relaxed),
+        .evictions = m_evictions.load(std::memory_order_relaxed),
+    };
+    for (const auto& shard : m_shards) {
+        std::scoped_lock lock(shard->mutex);
+        stats.entries += shard->lru.size();
+        stats.nbytes += shard->nbytes;
+    }
+    return stats;
+}
+
+ConfigRegistry::ConfigRegistry(std::vector<SchemaEntry> schema, size_t maxBytes, size_t maxEntries, size_t shards) :
+    SnapshotCache(maxBytes, maxEntries, shards), m_schema(std::move(schema)) {}
+
+std::shared_ptr<Snapshot> ConfigRegistry::load(const std::string& pathOrText, bool isStream) const {
+    return parseSnapshot(pathOrText, isStream, m_schema);
+}
+
+FileReadError::FileReadError(int error, std::string path) :
+    std::runtime_error(path + ": " + std::strerror(error)), m_error(error), m_path(std::move(path)) {}
+
+int FileReadError::error() const {
+    return m_error;
+}
+
+const std::string& FileReadError::path() const {
+    return m_path;
+}
+
+static uint64_t schemaFingerprint(const std::optional<std::vector<SchemaEntry>>& schema) {
+    if (!schema)
+        return 0; // inferred from the input, which is already keyed
+    uint64_t hash = hashBytes(nullptr, 0);
+    for (const auto& entry : *schema) {
+        hash = hashBytes(entry.name.data(), entry.name.size() + 1, hash); // with the NUL as a separator
+        hash = hashBytes(&entry.type, sizeof(entry.type), hash);
+        hash = hashBytes(&entry.i, sizeof(entry.i), hash);
+        hash = hashBytes(&entry.f, sizeof(entry.f), hash);
+        hash = hashBytes(&entry.vec, sizeof(entry.vec), hash);
+        hash = hashBytes(entry.str.data(), entry.str.size() + 1, hash);
+    }
+    return hash;
+}
+
+static std::vector<SchemaEntry> inferredEntries(std::string_view text) {
+    std::vector<SchemaEntry> entries;
+    for (auto& [name, type] : inferSchema(text))
+        entries.push_back({.name = std::move(name), .type = type});
+    return entries;
+}
+
+static bool hasSourceDirective(std::string_view text) {
+    while (!text.empty()) {
+        const auto end = text.find('\n');
+        if (!sourceDirectiveValue(text.substr(0, end)).empty())
+            return true;
+        text = end == std::string_view::npos ? std::string_view{} : text.substr(end + 1);
+    }
+    return false;
+}
+
+// Contents of `path`, read for schema inference. Throws FileReadError if it
+// cannot be opened.
+static std::string readConfigFile(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw FileReadError(errno, path);
+
+    std::string text;
+    char        buf[64 * 1024];
+    while (true) {
+        const auto n = read(fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            break;
+        text.append(buf, n);
+    }
+    close(fd);
+    return text;
+}
+
+std::shared_ptr<Snapshot> ParseCache::parse(std::string_view pathOrText, bool isStream, const std::optional<std::vector<SchemaEntry>>& schema,
+                                            const Hyprlang::SConfigOptions& options) {
+    char prefix[64];
+    std::snprintf(prefix, sizeof(prefix), "%c%016llx:%d%d%d:", isStream ? 's' : 'f', static_cast<unsigned long long>(schemaFingerprint(schema)), options.verifyOnly,
+                  options.throwAllErrors, options.allowMissingConfig);
+
+    std::string key = prefix;
+    if (isStream) {
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(hashBytes(pathOrText.data(), pathOrText.size())));
+        key += hash;
+    } else
+        key += canonicalPath(std::string{pathOrText});
+
+    // text is keyed by hash and stored with the entry, so a colliding text
+    // misses instead of getting another text's result
+    const auto input = isStream ? pathOrText : std::string_view{};
+    if (auto cached = find(key, input)) {
+        if (isStream || cached->stampsUnchanged())
+            return cached;
+        erase(key);
+    }
+
+    std::string              owned{pathOrText};
+    std::vector<SchemaEntry> entries;
+    if (schema)
+        entries = *schema;
+    else if (isStream)
+        entries = inferredEntries(pathOrText);
+    else
+        entries = inferredEntries(readConfigFile(owned));
+
+    auto snapshot = parseSnapshot(owned, isStream, entries, options);
+    if (isStream && hasSourceDirective(pathOrText))
+        return snapshot;
+    return insert(key, std::move(snapshot), isStream ? std::move(owned) : std::string{});
+}
+
+static std::atomic<std::shared_ptr<ParseCache>> sharedParseCache;
+
+std::shared_ptr<ParseCache> ParseCache::shared() {
+    return sharedParseCache.load();
+}
+
+void ParseCache::setShared(std::shared_ptr<ParseCache> cache) {
+    sharedParseCache.store(std::move(cache));
+}
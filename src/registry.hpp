@@ -0,0 +1,128 @@
+#pragma once
+
+#include "snapshot.hpp"
+#include "values.hpp"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct SnapshotCacheStats {
+    uint64_t hits      = 0;
+    uint64_t misses    = 0;
+    uint64_t evictions = 0;
+    size_t   entries   = 0;
+    size_t   nbytes    = 0;
+};
+
+// Snapshots keyed by string and evicted least-recently-used first. Entries
+// are spread over shards by key hash and each shard has its own lock and LRU
+// list, so lookups for different keys rarely contend. The byte and entry
+// budgets are split across shards, the remainder going one unit each to the
+// first shards, so the shard budgets add up to the totals; 0 means
+// unlimited. A shard never evicts the entry it just inserted.
+class SnapshotCache {
+  public:
+    SnapshotCache(size_t maxBytes, size_t maxEntries, size_t shards);
+
+    // Cached snapshot for `key`, or nullptr. An entry inserted with an
+    // `input` only matches the same input, for keys derived from a hash of
+    // it. Counts a hit or a miss.
+    std::shared_ptr<Snapshot> find(const std::string& key, std::string_view input = {});
+
+    // Caches `snapshot` for `key` and returns the cached entry, which is an
+    // earlier one if another thread inserted the same key and input first.
+    // An entry for the same key with another input is replaced. The input
+    // counts towards the byte budget.
+    std::shared_ptr<Snapshot> insert(const std::string& key, std::shared_ptr<Snapshot> snapshot, std::string input = {});
+
+    bool                      contains(const std::string& key) const;
+    bool                      erase(const std::string& key);
+    void                      clear();
+    SnapshotCacheStats        stats() const;
+
+  private:
+    struct Entry {
+        std::string               key;
+        std::string               input;
+        std::shared_ptr<Snapshot> snapshot;
+
+        size_t                    nbytes() const;
+    };
+
+    struct Shard {
+        mutable std::mutex                                          mutex;
+        std::list<Entry>                                            lru; // most recently used first
+        std::unordered_map<std::string, std::list<Entry>::iterator> index;
+        size_t                                                      nbytes     = 0;
+        size_t                                                      maxBytes   = 0;
+        size_t                                                      maxEntries = 0;
+    };
+
+    Shard&                              shardFor(const std::string& key) const;
+
+    std::vector<std::unique_ptr<Shard>> m_shards;
+
+    std::atomic<uint64_t>               m_hits      = 0;
+    std::atomic<uint64_t>               m_misses    = 0;
+    std::atomic<uint64_t>               m_evictions = 0;
+};
+
+// Snapshots of many configs sharing one schema, keyed by tenant id.
+class ConfigRegistry : public SnapshotCache {
+  public:
+    ConfigRegistry(std::vector<SchemaEntry> schema, size_t maxBytes, size_t maxEntries, size_t shards);
+
+    // Parses a config file (or config text, if `isStream`) against the
+    // schema. Throws std::runtime_error on parse errors. Takes no lock.
+    std::shared_ptr<Snapshot> load(const std::string& pathOrText, bool isStream) const;
+
+  private:
+    std::vector<SchemaEntry> m_schema;
+};
+
+// Thrown when a config file that has to be read cannot be opened; `error` is
+// the errno of the failed open().
+class FileReadError : public std::runtime_error {
+  public:
+    FileReadError(int error, std::string path);
+
+    int                error() const;
+    const std::string& path() const;
+
+  private:
+    int         m_error;
+    std::string m_path;
+};
+
+// Parse results keyed by their inputs, for services that see the same config
+// text again and again. Text is keyed by a hash of its contents and kept with
+// the entry, so a hit is confirmed by comparing it; a file is
+// keyed by its canonical path and revalidated on every hit against the
+// device, inode, size and mtime its sources had when it was parsed. Schema
+// and options are part of the key.
+class ParseCache : public SnapshotCache {
+  public:
+    using SnapshotCache::SnapshotCache;
+
+    // Snapshot of `pathOrText` parsed against `schema`, or against a schema
+    // inferred from the text (see inferSchema) when there is none. Text that
+    // sources other files is parsed but not cached, since those files are not
+    // tracked. Text is only copied on a miss. Throws FileReadError if the
+    // schema has to be inferred from a file that cannot be read, and
+    // std::runtime_error on parse errors.
+    std::shared_ptr<Snapshot>          parse(std::string_view pathOrText, bool isStream, const std::optional<std::vector<SchemaEntry>>& schema,
+                                             const Hyprlang::SConfigOptions& options);
+
+    // The process-wide cache used by parse_string() and parse_file(), or
+    // nullptr while caching is off.
+    static std::shared_ptr<ParseCache> shared();
+    static void                        setShared(std::shared_ptr<ParseCache> cache);
+};
@@ -0,0 +1,169 @@
+#include "shared.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+constexpr char SHARED_MAGIC[8] = {'H', 'Y', 'P', 'R', 'S', 'H', 'M', '1'};
+
+static std::string controlName(const std::string& name) {
+    return name.starts_with('/') ? name : "/" + name;
+}
+
+static std::string segmentName(const std::string& name, uint64_t generation) {
+    return controlName(name) + "." + std::to_string(generation);
+}
+
+static std::runtime_error sharedError(const std::string& what, const std::string& segment) {
+    return std::runtime_error(what + " " + segment + ": " + std::strerror(errno));
+}
+
+uint64_t publishSharedSnapshot(const std::string& name, const Snapshot& snapshot) {
+    const auto control = controlName(name);
+    int        fd      = shm_open(control.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0)
+        throw sharedError("Cannot open shared config", control);
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || (st.st_size < static_cast<off_t>(sizeof(SharedControl)) && ftruncate(fd, sizeof(SharedControl)) != 0)) {
+        close(fd);
+        throw sharedError("Cannot size shared config", control);
+    }
+
+    void* addr = mmap(nullptr, sizeof(SharedControl), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        throw sharedError("Cannot map shared config", control);
+
+    // a fresh segment is zero-filled, which is generation 0 with no magic yet
+    auto* ctl = static_cast<SharedControl*>(addr);
+    std::memcpy(ctl->magic, SHARED_MAGIC, sizeof(ctl->magic));
+    const uint64_t generation = ctl->generation.load(std::memory_order_acquire) + 1;
+
+    // a publisher that died before bumping the generation may have left this
+    // segment behind; it was never published, so no reader can be using it
+    const auto segment = segmentName(name, generation);
+    shm_unlink(segment.c_str());
+    fd = shm_open(segment.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 || ftruncate(fd, snapshot.nbytes()) != 0) {
+        auto err = sharedError("Cannot create shared config", segment);
+        if (fd >= 0) {
+            close(fd);
+            shm_unlink(segment.c_str());
+        }
+        munmap(addr, sizeof(SharedControl));
+        throw err;
+    }
+
+    void* data = mmap(nullptr, snapshot.nbytes(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        auto err = sharedError("Cannot map shared config", segment);
+        shm_unlink(segment.c_str());
+        munmap(addr, sizeof(SharedControl));
+        throw err;
+    }
+    std::memcpy(data, snapshot.data(), snapshot.nbytes());
+    munmap(data, snapshot.nbytes());
+
+    ctl->generation.store(generation, std::memory_order_release);
+    munmap(addr, sizeof(SharedControl));
+
+    if (generation > 2)
+        shm_unlink(segmentName(name, generation - 2).c_str());
+
+    return generation;
+}
+
+void unlinkSharedSnapshot(const std::string& name) {
+    const auto control = controlName(name);
+    int        fd      = shm_open(control.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return;
+
+    void* addr = mmap(nullptr, sizeof(SharedControl), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr != MAP_FAILED) {
+        const uint64_t generation = static_cast<const SharedControl*>(addr)->generation.load(std::memory_order_acquire);
+        munmap(addr, sizeof(SharedControl));
+        for (uint64_t g = generation; g > 0 && g + 2 > generation; --g)
+            shm_unlink(segmentName(name, g).c_str());
+    }
+    shm_unlink(control.c_str());
+}
+
+//
+
+SharedSnapshotView::SharedSnapshotView(const std::string& name) : m_name(name) {
+    const auto control = controlName(name);
+    int        fd      = shm_open(control.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        throw sharedError("Cannot attach shared config", control);
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(SharedControl))) {
+        close(fd);
+        throw std::runtime_error("Invalid shared config " + control);
+    }
+
+    void* addr = mmap(nullptr, sizeof(SharedControl), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        throw sharedError("Cannot map shared config", control);
+
+    m_control = static_cast<const SharedControl*>(addr);
+    if (std::memcmp(m_control->magic, SHARED_MAGIC, sizeof(SHARED_MAGIC)) != 0 || generation() == 0) {
+        munmap(addr, sizeof(SharedControl));
+        throw std::runtime_error("Nothing published under shared config " + control);
+    }
+}
+
+SharedSnapshotView::~SharedSnapshotView() {
+    if (m_control)
+        munmap(const_cast<SharedControl*>(m_control), sizeof(SharedControl));
+}
+
+uint64_t SharedSnapshotView::generation() const {
+    return m_control->generation.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<Snapshot> SharedSnapshotView::current() {
+    // the segment for a generation can be unlinked between reading the counter
+    // and opening it if the publisher moved on twice; re-read and try again
+    for (int attempt = 0; attempt < 16; ++attempt) {
+        const uint64_t g = generation();
+        if (g == m_mapped && m_snapshot)
+            return m_snapshot;
+
+        const auto segment = segmentName(m_name, g);
+        int        fd      = shm_open(segment.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            if (errno == ENOENT)
+                continue;
+            throw sharedError("Cannot open shared config", segment);
+        }
+
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            throw std::runtime_error("Invalid shared config " + segment);
+        }
+
+        const size_t size = st.st_size;
+        void*        addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (addr == MAP_FAILED)
+            throw sharedError("Cannot map shared config", segment);
+
+        std::shared_ptr<const void> owner(addr, [size](const void* p) { munmap(const_cast<void*>(p), size); });
+        m_snapshot = std::make_shared<Snapshot>(std::move(owner), static_cast<const uint8_t*>(addr), size);
+        m_mapped   = g;
+        return m_snapshot;
+    }
+
+    throw std::runtime_error("Shared config " + controlName(m_name) + " is republished faster than it can be attached");
+}
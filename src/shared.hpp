@@ -0,0 +1,53 @@
+#pragma once
+
+#include "snapshot.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Snapshots published into POSIX shared memory. A small control segment
+// "/<name>" holds the current generation; each generation's image lives in its
+// own segment "/<name>.<generation>". Publishing writes the new image, then
+// bumps the generation with a single atomic store, so readers never see a
+// partially written image and never take a lock. The previous generation is
+// kept for readers that raced the update; older ones are unlinked (existing
+// mappings stay valid until unmapped).
+
+struct SharedControl {
+    char                  magic[8];
+    std::atomic<uint64_t> generation;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared generation counter must be address-free");
+
+// Publishes `snapshot` under `name` and returns its generation. Only one
+// process should publish under a given name.
+uint64_t publishSharedSnapshot(const std::string& name, const Snapshot& snapshot);
+
+// Removes the control segment and the last two generations.
+void unlinkSharedSnapshot(const std::string& name);
+
+class SharedSnapshotView {
+  public:
+    // Attaches to the control segment. Throws std::runtime_error if nothing
+    // has been published under `name`.
+    explicit SharedSnapshotView(const std::string& name);
+    ~SharedSnapshotView();
+
+    SharedSnapshotView(const SharedSnapshotView&)            = delete;
+    SharedSnapshotView& operator=(const SharedSnapshotView&) = delete;
+
+    // Latest published generation.
+    uint64_t                  generation() const;
+
+    // Snapshot of the latest generation, remapped only when it changed.
+    std::shared_ptr<Snapshot> current();
+
+  private:
+    std::string               m_name;
+    const SharedControl*      m_control = nullptr;
+    uint64_t                  m_mapped  = 0;
+    std::shared_ptr<Snapshot> m_snapshot;
+};
@@ -0,0 +1,493 @@
+#include "snapshot.hpp"
+#include "includes.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tuple>
+#include <utility>
+#include <unistd.h>
+
+static uint64_t alignUp(uint64_t v) {
+    return (v + 7) & ~uint64_t{7};
+}
+
+uint64_t hashBytes(const void* data, size_t size, uint64_t seed) {
+    auto*    p = static_cast<const uint8_t*>(data);
+    uint64_t h = seed;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+bool hashFile(const std::string& path, uint64_t& size, uint64_t& hash, SourceStamp* stamp) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    // taken before reading, so an edit made while hashing shows as a change
+    if (stamp) {
+        struct stat st{};
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return false;
+        }
+        *stamp = SourceStamp::of(st);
+    }
+
+    char buf[64 * 1024];
+    size = 0;
+    hash = hashBytes(nullptr, 0);
+    while (true) {
+        auto n = read(fd, buf, sizeof(buf));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0) {
+            close(fd);
+            return false;
+        }
+        if (n == 0)
+            break;
+        hash = hashBytes(buf, n, hash);
+        size += n;
+    }
+    close(fd);
+    return true;
+}
+
+//
+
+SnapshotStr SnapshotBuilder::intern(std::string_view s) {
+    if (m_arena.size() + s.size() > UINT32_MAX)
+        throw std::length_error("Config snapshot string arena exceeds 4 GiB");
+
+    SnapshotStr ref{static_cast<uint32_t>(m_arena.size()), static_cast<uint32_t>(s.size())};
+    m_arena.append(s);
+    return ref;
+}
+
+std::string_view SnapshotBuilder::view(const SnapshotStr& s) const {
+    return std::string_view{m_arena}.substr(s.offset, s.length);
+}
+
+SnapshotValue SnapshotBuilder::encode(const std::any& value, bool setByUser) {
+    SnapshotValue out{};
+    out.type      = valueTypeOf(value);
+    out.setByUser = setByUser;
+
+    switch (out.type) {
+        case ValueType::INT: out.data.i = std::any_cast<int64_t>(value); break;
+        case ValueType::FLOAT: out.data.f = std::any_cast<float>(value); break;
+        case ValueType::STRING: {
+            const char* s = std::any_cast<const char*>(value);
+            out.data.str  = intern(s ? s : "");
+            break;
+        }
+        case ValueType::VEC2: {
+            auto v          = std::any_cast<Hyprlang::SVector2D>(value);
+            out.data.vec[0] = v.x;
+            out.data.vec[1] = v.y;
+            break;
+        }
+        // custom values are process-local pointers and are not carried over
+        default: out.type = value.has_value() ? ValueType::CUSTOM : ValueType::EMPTY; break;
+    }
+
+    return out;
+}
+
+void SnapshotBuilder::addValue(std::string_view name, const std::any& value, bool setByUser, uint16_t layer) {
+    SnapshotKey entry{};
+    entry.name        = intern(name);
+    entry.value       = encode(value, setByUser);
+    entry.value.layer = layer;
+    m_keys.push_back(entry);
+}
+
+void SnapshotBuilder::addSpecialValue(std::string_view category, std::string_view key, std::string_view name, const std::any& value, bool setByUser) {
+    std::string orderKey{category};
+    orderKey.push_back('\0');
+    orderKey.append(key);
+
+    auto it = m_keyOrder.find(orderKey);
+    if (it == m_keyOrder.end())
+        it = m_keyOrder.emplace(std::move(orderKey), m_categoryKeyCount[std::string{category}]++).first;
+
+    SnapshotSpecial entry{};
+    entry.category = intern(category);
+    entry.key      = intern(key);
+    entry.name     = intern(name);
+    entry.keyOrder = it->second;
+    entry.value    = encode(value, setByUser);
+    m_specials.push_back(entry);
+}
+
+// An edit within the filesystem's timestamp granularity of the one a stamp
+// was taken after can leave the same mtime (and, for a same-size in-place
+// write, the same stamp), so stamps this fresh are not trusted.
+constexpr time_t RECENT_MTIME_SECONDS = 2;
+
+static bool recentlyModified(const SourceStamp& stamp) {
+    timespec now{};
+    clock_gettime(CLOCK_REALTIME, &now);
+    return stamp.mtime.tv_sec >= now.tv_sec - RECENT_MTIME_SECONDS;
+}
+
+void SnapshotBuilder::addSource(const std::string& path) {
+    SnapshotSource entry{};
+    entry.path = intern(path);
+    SourceStamp stamp;
+    if (!hashFile(path, entry.size, entry.hash, &stamp)) {
+        entry.size = entry.hash = 0;
+        m_stamps.emplace_back();
+    } else if (recentlyModified(stamp))
+        m_stamps.emplace_back();
+    else
+        m_stamps.emplace_back(stamp);
+    m_sources.push_back(entry);
+}
+
+SourceStamps SnapshotBuilder::takeStamps() {
+    return std::move(m_stamps);
+}
+
+std::vector<uint8_t> SnapshotBuilder::build() {
+    std::stable_sort(m_keys.begin(), m_keys.end(), [this](const SnapshotKey& a, const SnapshotKey& b) { return view(a.name) < view(b.name); });
+    std::stable_sort(m_specials.begin(), m_specials.end(), [this](const SnapshotSpecial& a, const SnapshotSpecial& b) {
+        return std::tuple{view(a.category), view(a.key), view(a.name)} < std::tuple{view(b.category), view(b.key), view(b.name)};
+    });
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version        = SNAPSHOT_VERSION;
+    header.headerSize     = sizeof(SnapshotHeader);
+    header.keyCount       = m_keys.size();
+    header.keysOffset     = alignUp(sizeof(SnapshotHeader));
+    header.specialCount   = m_specials.size();
+    header.specialsOffset = alignUp(header.keysOffset + header.keyCount * sizeof(SnapshotKey));
+    header.sourceCount    = m_sources.size();
+    header.sourcesOffset  = alignUp(header.specialsOffset + header.specialCount * sizeof(SnapshotSpecial));
+    header.arenaOffset    = alignUp(header.sourcesOffset + header.sourceCount * sizeof(SnapshotSource));
+    header.arenaSize      = m_arena.size();
+    header.imageSize      = alignUp(header.arenaOffset + header.arenaSize);
+
+    std::vector<uint8_t> image(header.imageSize, 0);
+    std::memcpy(image.data(), &header, sizeof(header));
+    if (!m_keys.empty())
+        std::memcpy(image.data() + header.keysOffset, m_keys.data(), m_keys.size() * sizeof(SnapshotKey));
+    if (!m_specials.empty())
+        std::memcpy(image.data() + header.specialsOffset, m_specials.data(), m_specials.size() * sizeof(SnapshotSpecial));
+    if (!m_sources.empty())
+        std::memcpy(image.data() + header.sourcesOffset, m_sources.data(), m_sources.size() * sizeof(SnapshotSource));
+    if (!m_arena.empty())
+        std::memcpy(image.data() + header.arenaOffset, m_arena.data(), m_arena.size());
+
+    return image;
+}
+
+//
+
+Snapshot::Snapshot(std::shared_ptr<const void> owner, const uint8_t* data, size_t size) : m_owner(std::move(owner)), m_data(data), m_size(size) {
+    if (size < sizeof(SnapshotHeader) || reinterpret_cast<uintptr_t>(data) % alignof(SnapshotHeader) != 0)
+        throw std::runtime_error("Invalid config snapshot: truncated or misaligned image");
+
+    const auto* h = header();
+    if (std::memcmp(h->magic, SNAPSHOT_MAGIC, sizeof(h->magic)) != 0)
+        throw std::runtime_error("Invalid config snapshot: bad magic");
+    if (h->version != SNAPSHOT_VERSION)
+        throw std::runtime_error("Unsupported config snapshot version " + std::to_string(h->version));
+
+    auto sectionOk = [&](uint64_t offset, uint64_t count, size_t elem) { return offset % 8 == 0 && offset <= h->imageSize && count <= (h->imageSize - offset) / elem; };
+    if (h->headerSize != sizeof(SnapshotHeader) || h->imageSize > size || !sectionOk(h->keysOffset, h->keyCount, sizeof(SnapshotKey)) ||
+        !sectionOk(h->specialsOffset, h->specialCount, sizeof(SnapshotSpecial)) || !sectionOk(h->sourcesOffset, h->sourceCount, sizeof(SnapshotSource)) ||
+        h->arenaOffset > h->imageSize || h->arenaSize > h->imageSize - h->arenaOffset)
+        throw std::runtime_error("Invalid config snapshot: section out of bounds");
+
+    // validate every string reference once, so lookups can trust the tables
+    auto strOk   = [&](const SnapshotStr& s) { return uint64_t{s.offset} + s.length <= h->arenaSize; };
+    auto valueOk = [&](const SnapshotValue& v) { return v.type <= ValueType::CUSTOM && (v.type != ValueType::STRING || strOk(v.data.str)); };
+
+    bool ok = true;
+    for (size_t i = 0; ok && i < h->keyCount; ++i)
+        ok = strOk(keys()[i].name) && valueOk(keys()[i].value);
+    for (size_t i = 0; ok && i < h->specialCount; ++i) {
+        const auto& s = specials()[i];
+        ok            = strOk(s.category) && strOk(s.key) && strOk(s.name) && valueOk(s.value);
+    }
+    for (size_t i = 0; ok && i < h->sourceCount; ++i)
+        ok = strOk(sources()[i].path);
+    if (!ok)
+        throw std::runtime_error("Invalid config snapshot: string out of bounds");
+
+    m_size = h->imageSize;
+}
+
+std::shared_ptr<Snapshot> Snapshot::fromBytes(std::vector<uint8_t> bytes, SourceStamps stamps) {
+    auto        buffer   = std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+    const auto* data     = buffer->data();
+    const auto  size     = buffer->size();
+    auto        snapshot = std::make_shared<Snapshot>(std::move(buffer), data, size);
+    snapshot->m_stamps   = std::move(stamps);
+    return snapshot;
+}
+
+std::shared_ptr<Snapshot> Snapshot::mapFile(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error("Cannot open config snapshot " + path + ": " + std::strerror(errno));
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        throw std::runtime_error("Invalid config snapshot: " + path + " is empty or unreadable");
+    }
+
+    const size_t size = st.st_size;
+    void*        addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED)
+        throw std::runtime_error("Cannot map config snapshot " + path + ": " + std::strerror(errno));
+
+    std::shared_ptr<const void> owner(addr, [size](const void* p) { munmap(const_cast<void*>(p), size); });
+    return std::make_shared<Snapshot>(std::move(owner), static_cast<const uint8_t*>(addr), size);
+}
+
+const SnapshotHeader* Snapshot::header() const {
+    return reinterpret_cast<const SnapshotHeader*>(m_data);
+}
+
+const SnapshotKey* Snapshot::keys() const {
+    return reinterpret_cast<const SnapshotKey*>(m_data + header()->keysOffset);
+}
+
+const SnapshotSpecial* Snapshot::specials() const {
+    return reinterpret_cast<const SnapshotSpecial*>(m_data + header()->specialsOffset);
+}
+
+const SnapshotSource* Snapshot::sources() const {
+    return reinterpret_cast<const SnapshotSource*>(m_data + header()->sourcesOffset);
+}
+
+std::string_view Snapshot::str(const SnapshotStr& s) const {
+    return {reinterpret_cast<const char*>(m_data + header()->arenaOffset + s.offset), s.length};
+}
+
+const uint8_t* Snapshot::data() const {
+    return m_data;
+}
+
+size_t Snapshot::nbytes() const {
+    return m_size;
+}
+
+size_t Snapshot::keyCount() const {
+    return header()->keyCount;
+}
+
+std::string_view Snapshot::keyName(size_t i) const {
+    return str(keys()[i].name);
+}
+
+const SnapshotValue& Snapshot::valueAt(size_t i) const {
+    return keys()[i].value;
+}
+
+const SnapshotValue* Snapshot::find(std::string_view name) const {
+    const auto* begin = keys();
+    const auto* end   = begin + keyCount();
+    const auto* it    = std::lower_bound(begin, end, name, [this](const SnapshotKey& k, std::string_view n) { return str(k.name) < n; });
+    if (it == end || str(it->name) != name)
+        return nullptr;
+    return &it->value;
+}
+
+const SnapshotValue* Snapshot::findSpecial(std::string_view category, std::string_view name, std::string_view key) const {
+    const auto* begin  = specials();
+    const auto* end    = begin + header()->specialCount;
+    const auto  target = std::tuple{category, key, name};
+    const auto* it     = std::lower_bound(begin, end, target, [this](const SnapshotSpecial& s, const auto& t) { return std::tuple{str(s.category), str(s.key), str(s.name)} < t; });
+    if (it == end || std::tuple{str(it->category), str(it->key), str(it->name)} != target)
+        return nullptr;
+    return &it->value;
+}
+
+std::vector<std::string_view> Snapshot::specialKeys(std::string_view category) const {
+    const auto* begin = specials();
+    const auto* end   = begin + header()->specialCount;
+    const auto* first = std::lower_bound(begin, end, category, [this](const SnapshotSpecial& s, std::string_view c) { return str(s.category) < c; });
+    const auto* last  = std::upper_bound(first, end, category, [this](std::string_view c, const SnapshotSpecial& s) { return c < str(s.category); });
+
+    std::vector<std::pair<uint32_t, std::string_view>> ordered;
+    for (const auto* it = first; it != last; ++it) {
+        if (ordered.empty() || ordered.back().second != str(it->key))
+            ordered.emplace_back(it->keyOrder, str(it->key));
+    }
+    std::sort(ordered.begin(), ordered.end());
+
+    std::vector<std::string_view> result;
+    result.reserve(ordered.size());
+    for (const auto& [_, key] : ordered)
+        result.push_back(key);
+    return result;
+}
+
+size_t Snapshot::sourceCount() const {
+    return header()->sourceCount;
+}
+
+std::string_view Snapshot::sourcePath(size_t i) const {
+    return str(sources()[i].path);
+}
+
+bool Snapshot::sourceUnchanged(size_t i) const {
+    const auto& src  = sources()[i];
+    uint64_t    size = 0, hash = 0;
+    if (!hashFile(std::string{str(src.path)}, size, hash))
+        size = hash = 0;
+    return size == src.size && hash == src.hash;
+}
+
+bool Snapshot::sourcesUnchanged() const {
+    for (size_t i = 0; i < sourceCount(); ++i) {
+        if (!sourceUnchanged(i))
+            return false;
+    }
+    return true;
+}
+
+bool Snapshot::stampsUnchanged() const {
+    if (m_stamps.size() != sourceCount())
+        return sourcesUnchanged();
+    for (size_t i = 0; i < sourceCount(); ++i) {
+        if (m_stamps[i] ? SourceStamp::of(std::string{sourcePath(i)}) != m_stamps[i] : !sourceUnchanged(i))
+            return false;
+    }
+    return true;
+}
+
+void Snapshot::save(const std::string& path) const {
+    // a unique name in the target's directory, so concurrent writers never
+    // share a temp file and the rename stays on one filesystem
+    const std::filesystem::path target(path);
+    const auto                  dir = target.has_parent_path() ? target.parent_path() : std::filesystem::path(".");
+    std::string                 tmp = (dir / ("." + target.filename().string() + ".XXXXXX")).string();
+    int                         fd  = mkstemp(tmp.data());
+    if (fd < 0)
+        throw std::runtime_error("Cannot create a temporary file for config snapshot " + path + ": " + std::strerror(errno));
+
+    try {
+        const auto* p    = reinterpret_cast<const char*>(m_data);
+        size_t      left = m_size;
+        while (left) {
+            const auto n = write(fd, p, left);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+                throw std::runtime_error("Cannot write config snapshot " + tmp + ": " + std::strerror(errno));
+            p += n;
+            left -= n;
+        }
+        // mkstemp creates the file private to the owner
+        if (fchmod(fd, 0644) != 0 || close(std::exchange(fd, -1)) != 0)
+            throw std::runtime_error("Cannot write config snapshot " + tmp + ": " + std::strerror(errno));
+        std::filesystem::rename(tmp, path);
+    } catch (...) {
+        if (fd >= 0)
+            close(fd);
+        unlink(tmp.c_str());
+        throw;
+    }
+}
+
+//
+
+static void addSpecialValues(SnapshotBuilder& builder, Hyprlang::CConfig& config, const std::vector<std::pair<std::string, std::string>>& specialValues) {
+    for (const auto& [category, name] : specialValues) {
+        auto categoryKeys = config.listKeysForSpecialCategory(category.c_str());
+        if (categoryKeys.empty()) {
+            if (auto* ptr = config.getSpecialConfigValuePtr(category.c_str(), name.c_str(), nullptr))
+                builder.addSpecialValue(category, "", name, ptr->getValue(), ptr->m_bSetByUser);
+            continue;
+        }
+        for (const auto& key : categoryKeys) {
+            if (auto* ptr = config.getSpecialConfigValuePtr(category.c_str(), name.c_str(), key.c_str()))
+                builder.addSpecialValue(category, key, name, ptr->getValue(), ptr->m_bSetByUser);
+        }
+    }
+}
+
+void addConfigValues(SnapshotBuilder& builder, Hyprlang::CConfig& config, const std::vector<std::string>& keys,
+                     const std::vector<std::pair<std::string, std::string>>& specialValues) {
+    for (const auto& name : keys) {
+        if (auto* ptr = config.getConfigValuePtr(name.c_str()))
+            builder.addValue(name, ptr->getValue(), ptr->m_bSetByUser);
+    }
+    addSpecialValues(builder, config, specialValues);
+}
+
+void addConfigValues(SnapshotBuilder& builder, Hyprlang::CConfig& config, std::span<const KeyIndex::Entry> keys,
+                     const std::vector<std::pair<std::string, std::string>>& specialValues) {
+    for (const auto& key : keys) {
+        if (auto* ptr = key.value ? key.value : config.getConfigValuePtr(key.name.c_str()))
+            builder.addValue(key.name, ptr->getValue(), ptr->m_bSetByUser);
+    }
+    addSpecialValues(builder, config, specialValues);
+}
+
+std::shared_ptr<Snapshot> finishSnapshot(SnapshotBuilder& builder, const std::vector<std::string>& sources) {
+    for (const auto& path : collectSourceFiles(sources))
+        builder.addSource(path);
+
+    auto bytes = builder.build();
+    return Snapshot::fromBytes(std::move(bytes), builder.takeStamps());
+}
+
+std::shared_ptr<Snapshot> snapshotConfig(Hyprlang::CConfig& config, const std::vector<std::string>& keys,
+                                         const std::vector<std::pair<std::string, std::string>>& specialValues, const std::vector<std::string>& sources) {
+    SnapshotBuilder builder;
+    addConfigValues(builder, config, keys, specialValues);
+    return finishSnapshot(builder, sources);
+}
+
+std::shared_ptr<Snapshot> parseSnapshot(const std::string& pathOrText, bool isStream, const std::vector<SchemaEntry>& schema, Hyprlang::SConfigOptions options) {
+    options.pathIsStream = isStream;
+    std::optional<Hyprlang::CConfig> config;
+    Hyprlang::CParseResult           result;
+
+    // hyprlang throws bare C strings (e.g. "File does not exist"); turn them
+    // into errors that name the config, like createConfig does
+    const auto failed = [&](const std::string& what) {
+        return std::runtime_error(isStream ? "Failed to load config: " + what : "Failed to load config " + pathOrText + ": " + what);
+    };
+    try {
+        config.emplace(pathOrText.c_str(), options);
+        for (const auto& entry : schema)
+            addSchemaEntry(*config, entry);
+        config->commence();
+        result = config->parse();
+    } catch (const std::exception& e) {
+        throw failed(e.what());
+    } catch (const char* e) {
+        throw failed(e);
+    } catch (...) {
+        throw failed("unknown error");
+    }
+    if (result.error)
+        throw std::runtime_error(result.getError());
+
+    std::vector<std::string> keys;
+    keys.reserve(schema.size());
+    for (const auto& entry : schema)
+        keys.push_back(entry.name);
+
+    return snapshotConfig(*config, keys, {}, isStream ? std::vector<std::string>{} : std::vector<std::string>{pathOrText});
+}
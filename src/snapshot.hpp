@@ -0,0 +1,205 @@
+#pragma once
+
+#include "keyindex.hpp"
+#include "sources.hpp"
+#include "values.hpp"
+
+#include <any>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// A snapshot is a flat, position-independent image of parsed config values:
+// a header, a key table sorted by name, a special-category table, the source
+// files the values came from and a string arena. Images are read in place, so
+// the same reader serves a file mapping, an owned buffer or any other memory.
+
+constexpr char     SNAPSHOT_MAGIC[8] = {'H', 'Y', 'P', 'R', 'S', 'N', 'A', 'P'};
+constexpr uint32_t SNAPSHOT_VERSION  = 1;
+
+struct SnapshotStr {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct SnapshotValue {
+    ValueType type;
+    uint8_t   setByUser;
+    uint16_t  layer; // 1-based layer the value came from in a layered snapshot, 0 otherwise
+    uint8_t   reserved[4];
+    union {
+        int64_t     i;
+        float       f;
+        float       vec[2];
+        SnapshotStr str;
+    } data;
+};
+
+struct SnapshotKey {
+    SnapshotStr   name;
+    SnapshotValue value;
+};
+
+struct SnapshotSpecial {
+    SnapshotStr   category;
+    SnapshotStr   key;
+    SnapshotStr   name;
+    uint32_t      keyOrder; // position of `key` in its category, for listing keys in parse order
+    uint32_t      reserved;
+    SnapshotValue value;
+};
+
+struct SnapshotSource {
+    SnapshotStr path;
+    uint64_t    size;
+    uint64_t    hash;
+};
+
+struct SnapshotHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    uint64_t imageSize;
+    uint64_t keyCount;
+    uint64_t keysOffset;
+    uint64_t specialCount;
+    uint64_t specialsOffset;
+    uint64_t sourceCount;
+    uint64_t sourcesOffset;
+    uint64_t arenaOffset;
+    uint64_t arenaSize;
+};
+
+static_assert(sizeof(SnapshotValue) == 16);
+static_assert(sizeof(SnapshotKey) == 24);
+static_assert(sizeof(SnapshotSpecial) == 48);
+static_assert(sizeof(SnapshotSource) == 24);
+
+// 64-bit FNV-1a, used for source validation.
+uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325ULL);
+
+// Hashes a file's contents. Returns false if it cannot be read. `stamp`, if
+// given, receives the version of the file that was hashed.
+bool hashFile(const std::string& path, uint64_t& size, uint64_t& hash, SourceStamp* stamp = nullptr);
+
+// The version of each source a snapshot was built from, in the order the
+// sources were recorded. nullopt where only the hash can tell whether the
+// source changed: it was missing, or modified so shortly before it was read
+// that a later edit could leave the same stamp.
+using SourceStamps = std::vector<std::optional<SourceStamp>>;
+
+class SnapshotBuilder {
+  public:
+    void                 addValue(std::string_view name, const std::any& value, bool setByUser, uint16_t layer = 0);
+    void                 addSpecialValue(std::string_view category, std::string_view key, std::string_view name, const std::any& value, bool setByUser);
+
+    // Records a source file with its current size and hash (both zero if it is missing).
+    void                 addSource(const std::string& path);
+
+    std::vector<uint8_t> build();
+
+    // Versions of the sources added so far, in order.
+    SourceStamps         takeStamps();
+
+  private:
+    SnapshotStr                  intern(std::string_view s);
+    SnapshotValue                encode(const std::any& value, bool setByUser);
+    std::string_view             view(const SnapshotStr& s) const;
+
+    std::vector<SnapshotKey>     m_keys;
+    std::vector<SnapshotSpecial> m_specials;
+    std::vector<SnapshotSource>  m_sources;
+    SourceStamps                 m_stamps;
+    std::string                  m_arena;
+
+    // first-seen order of special keys, by category and by "category\0key"
+    std::unordered_map<std::string, uint32_t> m_categoryKeyCount;
+    std::unordered_map<std::string, uint32_t> m_keyOrder;
+};
+
+class Snapshot {
+  public:
+    // `owner` keeps `data` alive for the lifetime of the snapshot. Throws
+    // std::runtime_error if the image is malformed or from another version.
+    Snapshot(std::shared_ptr<const void> owner, const uint8_t* data, size_t size);
+
+    // `stamps` are the versions of the recorded sources the image was built
+    // from, if known (see stampsUnchanged).
+    static std::shared_ptr<Snapshot> fromBytes(std::vector<uint8_t> bytes, SourceStamps stamps = {});
+    static std::shared_ptr<Snapshot> mapFile(const std::string& path);
+
+    size_t                           keyCount() const;
+    std::string_view                 keyName(size_t i) const;
+    const SnapshotValue&             valueAt(size_t i) const;
+    const SnapshotValue*             find(std::string_view name) const;
+
+    const SnapshotValue*             findSpecial(std::string_view category, std::string_view name, std::string_view key) const;
+    std::vector<std::string_view>    specialKeys(std::string_view category) const;
+
+    size_t                           sourceCount() const;
+    std::string_view                 sourcePath(size_t i) const;
+
+    // True if every recorded source still has the size and hash it had when
+    // the snapshot was built.
+    bool                             sourcesUnchanged() const;
+
+    // Like sourcesUnchanged(), but compares the device, inode, size and mtime
+    // each source had when the image was built, which costs one stat per
+    // source; sources without a stamp are hashed. Falls back to
+    // sourcesUnchanged() for images without stamps, such as ones read back
+    // from a file.
+    bool                             stampsUnchanged() const;
+
+    std::string_view                 str(const SnapshotStr& s) const;
+    const uint8_t*                   data() const;
+    size_t                           nbytes() const;
+
+    // Writes the image to a fresh temp file (mode 0644) next to `path` and
+    // renames it into place. The temp file is removed if anything fails.
+    void                             save(const std::string& path) const;
+
+  private:
+    const SnapshotHeader*       header() const;
+    const SnapshotKey*          keys() const;
+    const SnapshotSpecial*      specials() const;
+    const SnapshotSource*       sources() const;
+    bool                        sourceUnchanged(size_t i) const;
+
+    std::shared_ptr<const void> m_owner;
+    SourceStamps                m_stamps;
+    const uint8_t*              m_data = nullptr;
+    size_t                      m_size = 0;
+};
+
+// Parses a config file (or config text, if `isStream`) against `schema` and
+// returns a snapshot of the schema's keys, recording the file and its includes
+// as sources. `options.pathIsStream` is overridden by `isStream`. Throws
+// std::runtime_error on parse errors.
+std::shared_ptr<Snapshot> parseSnapshot(const std::string& pathOrText, bool isStream, const std::vector<SchemaEntry>& schema, Hyprlang::SConfigOptions options = {});
+
+// Copies `keys` and every instance of the given (category, name) special
+// values out of `config` into `builder`. This is the only step of
+// snapshotConfig() that reads the config.
+void addConfigValues(SnapshotBuilder& builder, Hyprlang::CConfig& config, const std::vector<std::string>& keys,
+                     const std::vector<std::pair<std::string, std::string>>& specialValues);
+
+// The same for registered keys, read through their value pointers when
+// already resolved.
+void addConfigValues(SnapshotBuilder& builder, Hyprlang::CConfig& config, std::span<const KeyIndex::Entry> keys,
+                     const std::vector<std::pair<std::string, std::string>>& specialValues);
+
+// Records `sources` and every file they include, then builds the image.
+// Touches no config state, so it can run without holding a config lock.
+std::shared_ptr<Snapshot> finishSnapshot(SnapshotBuilder& builder, const std::vector<std::string>& sources);
+
+// Builds a snapshot of `keys` and of every instance of the given
+// (category, name) special values, recording `sources` and every file they
+// include for later validation.
+std::shared_ptr<Snapshot> snapshotConfig(Hyprlang::CConfig& config, const std::vector<std::string>& keys,
+                                         const std::vector<std::pair<std::string, std::string>>& specialValues, const std::vector<std::string>& sources);
@@ -0,0 +1,477 @@
+#include "sources.hpp"
+#include "includes.hpp"
+#include "snapshot.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <filesystem>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+constexpr size_t SHARED_SOURCE_CACHE_BYTES = 64 << 20;
+constexpr size_t BUNDLE_CACHE_ENTRIES      = 256;
+
+bool SourceStamp::operator==(const SourceStamp& other) const {
+    return dev == other.dev && ino == other.ino && size == other.size && mtime.tv_sec == other.mtime.tv_sec && mtime.tv_nsec == other.mtime.tv_nsec;
+}
+
+SourceStamp SourceStamp::of(const struct stat& st) {
+    return {st.st_dev, st.st_ino, st.st_size, st.st_mtim};
+}
+
+std::optional<SourceStamp> SourceStamp::of(const std::string& path) {
+    struct stat st{};
+    if (stat(path.c_str(), &st) != 0)
+        return std::nullopt;
+    return of(st);
+}
+
+std::string canonicalPath(const std::string& path) {
+    char resolved[PATH_MAX];
+    return realpath(path.c_str(), resolved) ? std::string{resolved} : path;
+}
+
+SourceCache::SourceCache(size_t maxBytes) : m_maxBytes(maxBytes) {}
+
+SourceCache& SourceCache::shared() {
+    static SourceCache cache(SHARED_SOURCE_CACHE_BYTES);
+    return cache;
+}
+
+std::shared_ptr<const std::string> SourceCache::read(const std::string& path, SourceStamp* stamp) {
+    char resolved[PATH_MAX];
+    if (!realpath(path.c_str(), resolved)) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    const std::string canonical = resolved;
+
+    const int         fd = open(resolved, O_RDONLY | O_CLOEXEC);
+    struct stat       st{};
+    if (fd < 0 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        if (fd >= 0)
+            close(fd);
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    const auto current = SourceStamp::of(st);
+    if (stamp)
+        *stamp = current;
+
+    {
+        std::scoped_lock lock(m_mutex);
+        if (auto it = m_index.find(canonical); it != m_index.end() && it->second->stamp == current) {
+            close(fd);
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return it->second->contents;
+        }
+    }
+
+    m_misses.fetch_add(1, std::memory_order_relaxed);
+
+    // read without the lock, so a slow file does not stall other lookups
+    std::string text(st.st_size, '\0');
+    size_t      done = 0;
+    while (done < text.size()) {
+        const ssize_t n = ::read(fd, text.data() + done, text.size() - done);
+        if (n <= 0)
+            break;
+        done += n;
+    }
+    close(fd);
+    if (done != text.size())
+        return nullptr; // changed while reading; do not cache a torn copy
+
+    auto             contents = std::make_shared<const std::string>(std::move(text));
+
+    std::scoped_lock lock(m_mutex);
+    if (auto it = m_index.find(canonical); it != m_index.end()) {
+        m_nbytes -= it->second->contents->size();
+        m_lru.erase(it->second);
+        m_index.erase(it);
+    }
+
+    m_nbytes += contents->size();
+    m_lru.push_front(Entry{canonical, current, contents});
+    m_index.emplace(canonical, m_lru.begin());
+    evict();
+    return contents;
+}
+
+void SourceCache::evict() {
+    while (m_lru.size() > 1 && m_maxBytes && m_nbytes > m_maxBytes) {
+        auto& victim = m_lru.back();
+        m_nbytes -= victim.contents->size();
+        m_index.erase(victim.path);
+        m_lru.pop_back();
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void SourceCache::setMaxBytes(size_t maxBytes) {
+    std::scoped_lock lock(m_mutex);
+    m_maxBytes = maxBytes;
+    evict();
+}
+
+void SourceCache::clear() {
+    std::scoped_lock lock(m_mutex);
+    m_lru.clear();
+    m_index.clear();
+    m_nbytes = 0;
+}
+
+SourceCacheStats SourceCache::stats() const {
+    std::scoped_lock lock(m_mutex);
+    return {
+        .hits      = m_hits.load(std::memory_order_relaxed),
+        .misses    = m_misses.load(std::memory_order_relaxed),
+        .evictions = m_evictions.load(std::memory_order_relaxed),
+        .entries   = m_lru.size(),
+        .nbytes    = m_nbytes,
+        .maxBytes  = m_maxBytes,
+    };
+}
+
+// Walks a config and its includes, writing the flattened text to `out`. With
+// a bundle, marker comments and the line map are written too.
+struct BundleWriter {
+    SourceCache&             cache;
+    Bundle*                  bundle = nullptr;
+    LineMap*                 map    = nullptr;
+    std::string&             out;
+    std::vector<std::string> stack; // canonical paths of the files being expanded
+    size_t                   lines = 0;
+
+    void                     input(const std::string& path, const SourceStamp& stamp) {
+        if (bundle)
+            bundle->m_inputs.emplace_back(path, stamp);
+    }
+
+    uint32_t fileIndex(const std::string& canonical) {
+        auto& files = bundle->m_files;
+        for (size_t i = 0; i < files.size(); ++i) {
+            if (files[i] == canonical)
+                return i;
+        }
+        files.push_back(canonical);
+        return files.size() - 1;
+    }
+
+    void expand(std::string_view text, const std::string& file) {
+        const auto canonical   = stack.back();
+        size_t     line        = 0;
+        bool       needsMarker = bundle != nullptr;
+
+        while (!text.empty()) {
+            const auto end = text.find('\n');
+            const auto raw = text.substr(0, end);
+            text           = end == std::string_view::npos ? std::string_view{} : text.substr(end + 1);
+            ++line;
+
+            const auto value = sourceDirectiveValue(raw);
+            const auto files = resolveSourceDirective(value, file);
+            std::vector<std::shared_ptr<const std::string>> contents;
+            std::vector<SourceStamp>                        stamps(files.size());
+            for (size_t i = 0; i < files.size(); ++i) {
+                auto data = cache.read(files[i], &stamps[i]);
+                if (!data)
+                    break;
+                contents.push_back(std::move(data));
+            }
+
+            if (files.empty() || contents.size() != files.size()) {
+                if (needsMarker) {
+                    out.append("#@ " + std::to_string(line) + " " + canonical + "\n");
+                    bundle->m_segments.push_back({lines + 2, fileIndex(canonical), line});
+                    ++lines;
+                    needsMarker = false;
+                }
+                if (map)
+                    map->add(lines + 1, canonical, line);
+                // a bundle keeps the line as written; plain expansions are
+                // parsed from another path, so relative includes are pinned
+                const auto pinned = bundle ? std::nullopt : absoluteSourceLine(raw, file);
+                // a comment that reads like a marker stays a comment, but not
+                // one the reader would take for a marker
+                if (bundle && raw.starts_with("#@ "))
+                    out.append("# ");
+                out.append(pinned ? std::string_view{*pinned} : raw);
+                out.push_back('\n');
+                ++lines;
+                continue;
+            }
+
+            // a glob picks up files added later, so its directory is an input
+            if (value.find_first_of("*?[") != std::string_view::npos) {
+                const auto dir = std::filesystem::path(files.front()).parent_path().string();
+                if (auto stamp = SourceStamp::of(dir))
+                    input(canonicalPath(dir), *stamp);
+            }
+
+            for (size_t i = 0; i < files.size(); ++i) {
+                auto child = canonicalPath(files[i]);
+                for (const auto& open : stack) {
+                    if (open == child)
+                        throw std::runtime_error("Source loop: " + files[i] + " sources itself");
+                }
+                input(child, stamps[i]);
+                stack.push_back(std::move(child));
+                expand(*contents[i], files[i]);
+                stack.pop_back();
+            }
+            needsMarker = bundle != nullptr;
+        }
+    }
+
+    void expandRoot(const std::string& path) {
+        SourceStamp stamp;
+        auto        root = cache.read(path, &stamp);
+        if (!root)
+            throw std::runtime_error("Config file " + path + " could not be read");
+        stack.push_back(canonicalPath(path));
+        input(stack.back(), stamp);
+        expand(*root, path);
+    }
+};
+
+std::string expandSources(const std::string& pathOrText, bool isStream, SourceCache& cache, const std::string& streamBase, LineMap* map) {
+    std::string  out;
+    BundleWriter writer{.cache = cache, .map = map, .out = out};
+    if (isStream) {
+        writer.stack.push_back("");
+        writer.expand(pathOrText, streamBase);
+    } else
+        writer.expandRoot(pathOrText);
+    return out;
+}
+
+void LineMap::add(size_t line, const std::string& file, size_t fileLine) {
+    if (!m_segments.empty()) {
+        const auto& last = m_segments.back();
+        if (m_files[last.file] == file && last.line + (line - last.start) == fileLine)
+            return; // continues the current segment
+    }
+
+    uint32_t index = 0;
+    while (index < m_files.size() && m_files[index] != file)
+        ++index;
+    if (index == m_files.size())
+        m_files.push_back(file);
+    m_segments.push_back({line, index, fileLine});
+}
+
+std::optional<std::pair<std::string, size_t>> LineMap::origin(size_t line) const {
+    // the last segment starting at or before `line`
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), line, [](size_t l, const Segment& s) { return l < s.start; });
+    if (it == m_segments.begin())
+        return std::nullopt;
+    --it;
+    return std::pair{m_files[it->file], it->line + (line - it->start)};
+}
+
+std::string LineMap::rewriteError(std::string_view message, std::string_view parsedAs) const {
+    if (parsedAs.empty())
+        return std::string{message};
+
+    std::string out;
+    size_t      pos = 0;
+    for (size_t at = message.find(parsedAs); at != std::string_view::npos; at = message.find(parsedAs, at)) {
+        const auto pathEnd = at + parsedAs.size();
+        const auto next    = message.find(parsedAs, pathEnd);
+        const auto lineAt  = message.substr(0, next).find("line ", pathEnd);
+        at                 = pathEnd;
+        if (lineAt == std::string_view::npos)
+            continue;
+
+        const auto digits = lineAt + 5;
+        auto       end    = digits;
+        while (end < message.size() && message[end] >= '0' && message[end] <= '9')
+            ++end;
+        size_t line = 0;
+        if (std::from_chars(message.data() + digits, message.data() + end, line).ec != std::errc{})
+            continue;
+        const auto from = origin(line);
+        if (!from)
+            continue;
+
+        out.append(message.substr(pos, pathEnd - parsedAs.size() - pos));
+        out.append(from->first.empty() ? "<stream>" : from->first);
+        out.append(message.substr(pathEnd, digits - pathEnd));
+        out.append(std::to_string(from->second));
+        pos = at = end;
+    }
+    out.append(message.substr(pos));
+    return out;
+}
+
+MemFile::MemFile() : m_fd(memfd_create("hyprlang-pybind", MFD_CLOEXEC)) {
+    if (m_fd < 0)
+        throw std::runtime_error("Failed to create an in-memory config file");
+}
+
+MemFile::~MemFile() {
+    close(m_fd);
+}
+
+void MemFile::write(std::string_view text) {
+    if (ftruncate(m_fd, text.size()) != 0)
+        throw std::runtime_error("Failed to write an in-memory config file");
+    size_t done = 0;
+    while (done < text.size()) {
+        const ssize_t n = pwrite(m_fd, text.data() + done, text.size() - done, done);
+        if (n <= 0)
+            throw std::runtime_error("Failed to write an in-memory config file");
+        done += n;
+    }
+}
+
+std::string MemFile::path() const {
+    return "/proc/self/fd/" + std::to_string(m_fd);
+}
+
+static std::string bundleHeader(uint64_t hash) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "# hyprlang bundle %016llx\n", static_cast<unsigned long long>(hash));
+    return buf;
+}
+
+std::shared_ptr<Bundle> Bundle::build(const std::string& path, SourceCache& cache) {
+    static std::mutex                                               mutex;
+    static std::unordered_map<std::string, std::shared_ptr<Bundle>> built;
+
+    const auto                                                      key = canonicalPath(path);
+    {
+        std::scoped_lock lock(mutex);
+        if (auto it = built.find(key); it != built.end() && it->second->isCurrent())
+            return it->second;
+    }
+
+    auto         bundle = std::make_shared<Bundle>();
+    std::string  body;
+    BundleWriter writer{.cache = cache, .bundle = bundle.get(), .out = body};
+    writer.expandRoot(path);
+
+    // the header is line 1, so every line moves down by one
+    for (auto& segment : bundle->m_segments)
+        ++segment.start;
+    bundle->m_hash = hashBytes(body.data(), body.size());
+    bundle->m_text = bundleHeader(bundle->m_hash) + body;
+
+    std::scoped_lock lock(mutex);
+    if (built.size() >= BUNDLE_CACHE_ENTRIES && !built.contains(key))
+        built.erase(built.begin());
+    built[key] = bundle;
+    return bundle;
+}
+
+std::shared_ptr<Bundle> Bundle::fromText(std::string text) {
+    const auto headerEnd = text.find('\n');
+    const auto header    = std::string_view{text}.substr(0, headerEnd);
+    constexpr std::string_view PREFIX = "# hyprlang bundle ";
+    uint64_t   hash      = 0;
+    if (!header.starts_with(PREFIX) || headerEnd == std::string::npos)
+        throw std::runtime_error("Not a config bundle");
+    const auto digits = header.substr(PREFIX.size());
+    if (std::from_chars(digits.data(), digits.data() + digits.size(), hash, 16).ec != std::errc{})
+        throw std::runtime_error("Not a config bundle");
+
+    const auto body = std::string_view{text}.substr(headerEnd + 1);
+    if (hashBytes(body.data(), body.size()) != hash)
+        throw std::runtime_error("Config bundle is corrupt: hash mismatch");
+
+    auto bundle    = std::make_shared<Bundle>();
+    bundle->m_hash = hash;
+
+    size_t lineNo = 1;
+    for (auto rest = body; !rest.empty();) {
+        const auto end  = rest.find('\n');
+        const auto line = rest.substr(0, end);
+        rest            = end == std::string_view::npos ? std::string_view{} : rest.substr(end + 1);
+        ++lineNo;
+
+        if (!line.starts_with("#@ "))
+            continue;
+        const auto fields = line.substr(3);
+        const auto space  = fields.find(' ');
+        size_t     from   = 0;
+        if (space == std::string_view::npos || std::from_chars(fields.data(), fields.data() + space, from).ec != std::errc{})
+            throw std::runtime_error("Config bundle has a malformed marker at line " + std::to_string(lineNo));
+
+        const std::string file{fields.substr(space + 1)};
+        uint32_t          index = 0;
+        while (index < bundle->m_files.size() && bundle->m_files[index] != file)
+            ++index;
+        if (index == bundle->m_files.size())
+            bundle->m_files.push_back(file);
+        bundle->m_segments.push_back({lineNo + 1, index, from});
+    }
+
+    bundle->m_text = std::move(text);
+    return bundle;
+}
+
+const std::string& Bundle::text() const {
+    return m_text;
+}
+
+uint64_t Bundle::hash() const {
+    return m_hash;
+}
+
+const std::vector<std::string>& Bundle::files() const {
+    return m_files;
+}
+
+std::optional<std::pair<std::string, size_t>> Bundle::origin(size_t line) const {
+    // the last segment starting at or before `line`
+    auto it = std::upper_bound(m_segments.begin(), m_segments.end(), line, [](size_t l, const Segment& s) { return l < s.start; });
+    if (it == m_segments.begin())
+        return std::nullopt;
+    --it;
+
+    // a marker line is the line just before the next segment
+    if (auto next = it + 1; next != m_segments.end() && line + 1 == next->start)
+        return std::nullopt;
+    return std::pair{m_files[it->file], it->line + (line - it->start)};
+}
+
+std::string Bundle::annotateError(std::string_view message) const {
+    std::string out;
+    size_t      pos = 0;
+    for (size_t at = message.find("line "); at != std::string_view::npos; at = message.find("line ", at)) {
+        const auto digits = at + 5;
+        auto       end    = digits;
+        while (end < message.size() && message[end] >= '0' && message[end] <= '9')
+            ++end;
+        at = end;
+
+        size_t line = 0;
+        if (std::from_chars(message.data() + digits, message.data() + end, line).ec != std::errc{})
+            continue;
+        auto from = origin(line);
+        if (!from)
+            continue;
+
+        out.append(message.substr(pos, end - pos));
+        out.append(" (" + from->first + ":" + std::to_string(from->second) + ")");
+        pos = end;
+    }
+    out.append(message.substr(pos));
+    return out;
+}
+
+bool Bundle::isCurrent() const {
+    for (const auto& [path, stamp] : m_inputs) {
+        if (SourceStamp::of(path) != stamp)
+            return false;
+    }
+    return true;
+}
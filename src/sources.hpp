@@ -0,0 +1,196 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Identifies the version of a file a cached copy was read from.
+struct SourceStamp {
+    dev_t                             dev   = 0;
+    ino_t                             ino   = 0;
+    off_t                             size  = 0;
+    timespec                          mtime = {};
+
+    bool                              operator==(const SourceStamp& other) const;
+
+    static SourceStamp                of(const struct stat& st);
+    static std::optional<SourceStamp> of(const std::string& path);
+};
+
+// realpath() of `path`, or `path` itself if it cannot be resolved.
+std::string canonicalPath(const std::string& path);
+
+struct SourceCacheStats {
+    uint64_t hits      = 0;
+    uint64_t misses    = 0;
+    uint64_t evictions = 0;
+    size_t   entries   = 0;
+    size_t   nbytes    = 0;
+    size_t   maxBytes  = 0;
+};
+
+// Contents of config files keyed by canonical path, read once and shared by
+// every config that sources them. An entry is reused only while the file's
+// device, inode, size and mtime still match, so an edited file is read
+// again. Entries are evicted least-recently-used first once the contents
+// exceed `maxBytes` (0 means unlimited); an entry still held by a reader stays
+// alive until it is released.
+class SourceCache {
+  public:
+    explicit SourceCache(size_t maxBytes);
+
+    // The process-wide cache used by configs with the source cache enabled.
+    static SourceCache&                shared();
+
+    // Contents of `path`, or nullptr if it cannot be read. Counts a hit or a
+    // miss. `stamp`, if given, receives the version that was returned.
+    std::shared_ptr<const std::string> read(const std::string& path, SourceStamp* stamp = nullptr);
+
+    void                               setMaxBytes(size_t maxBytes);
+    void                               clear();
+    SourceCacheStats                   stats() const;
+
+  private:
+    struct Entry {
+        std::string                        path;
+        SourceStamp                        stamp;
+        std::shared_ptr<const std::string> contents;
+    };
+
+    void                                                        evict();
+
+    mutable std::mutex                                          m_mutex;
+    std::list<Entry>                                            m_lru; // most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> m_index;
+    size_t                                                      m_nbytes   = 0;
+    size_t                                                      m_maxBytes = 0;
+
+    std::atomic<uint64_t>                                       m_hits      = 0;
+    std::atomic<uint64_t>                                       m_misses    = 0;
+    std::atomic<uint64_t>                                       m_evictions = 0;
+};
+
+class LineMap;
+
+// Inlines every source directive that can be resolved statically (see
+// resolveSourceDirective) with the contents of the files it names, read
+// through `cache`, and returns the result as one config text. Directives
+// naming a file that cannot be read, or using variables, are kept as they are
+// so hyprlang handles them, with relative paths made absolute so the text
+// can be parsed from anywhere; a stream's are relative to `streamBase` (the
+// working directory if empty). The root is read through the cache too unless
+// `isStream`. With `map`, records where each line came from. Throws
+// std::runtime_error on a source loop.
+std::string expandSources(const std::string& pathOrText, bool isStream, SourceCache& cache, const std::string& streamBase = "", LineMap* map = nullptr);
+
+// The file and line each line of an expanded text (see expandSources) came
+// from, for reporting parse errors against the original files.
+class LineMap {
+  public:
+    // Records that text line `line` (1-based) is line `fileLine` of `file`
+    // (canonical; empty for a stream root).
+    void                                          add(size_t line, const std::string& file, size_t fileLine);
+
+    std::optional<std::pair<std::string, size_t>> origin(size_t line) const;
+
+    // Rewrites every "<parsedAs> ... line N" location in a hyprlang error
+    // message to the file and line the text line came from. A stream root is
+    // named "<stream>".
+    std::string                                   rewriteError(std::string_view message, std::string_view parsedAs) const;
+
+  private:
+    // Text lines from `start` on come from `files[file]`, starting at `line`.
+    struct Segment {
+        size_t   start = 0;
+        uint32_t file  = 0;
+        size_t   line  = 0;
+    };
+
+    std::vector<std::string> m_files;
+    std::vector<Segment>     m_segments;
+};
+
+// An anonymous in-memory file, so text built at runtime can be handed to
+// hyprlang's parseFile() by path. Throws std::runtime_error if it cannot be
+// created or written.
+class MemFile {
+  public:
+    MemFile();
+    ~MemFile();
+    MemFile(const MemFile&)            = delete;
+    MemFile& operator=(const MemFile&) = delete;
+
+    // Replaces the contents with `text`.
+    void        write(std::string_view text);
+
+    // A path that opens the file, valid while this object lives.
+    std::string path() const;
+
+  private:
+    int m_fd = -1;
+};
+
+// A config with everything it sources flattened into one self-contained
+// text. Marker comments in the text map each line back to the file and line
+// it came from, so the text alone can be shipped and parsed as a stream:
+//
+//   # hyprlang bundle <hash>
+//   #@ <line> <path>
+//
+// The hash is 64-bit FNV-1a over everything after the header. Config lines
+// that start with "#@ " are written as "# #@ ", so only the writer's own
+// markers start with it.
+class Bundle {
+  public:
+    // Flattens the config at `path`, reading it and its includes through
+    // `cache`. A bundle built earlier for the same root is returned as is
+    // while none of its inputs changed, which costs one stat per input.
+    // Throws std::runtime_error if the root cannot be read or on a source
+    // loop.
+    static std::shared_ptr<Bundle>                build(const std::string& path, SourceCache& cache);
+
+    // Reads a bundle back from its text. Throws std::runtime_error if the
+    // header is missing or the hash does not match.
+    static std::shared_ptr<Bundle>                fromText(std::string text);
+
+    const std::string&                            text() const;
+    uint64_t                                      hash() const;
+    const std::vector<std::string>&               files() const;
+
+    // File and line that line `line` (1-based) of the text came from, or
+    // nullopt for marker lines.
+    std::optional<std::pair<std::string, size_t>> origin(size_t line) const;
+
+    // Adds " (file:line)" after each "line N" in a hyprlang error message.
+    std::string                                   annotateError(std::string_view message) const;
+
+    // False once a file, or a directory a glob was expanded in, has changed
+    // since build(). Always true for bundles read with fromText().
+    bool                                          isCurrent() const;
+
+  private:
+    friend struct BundleWriter;
+
+    // Text lines from `start` on come from `files[file]`, starting at `line`.
+    struct Segment {
+        size_t   start = 0;
+        uint32_t file  = 0;
+        size_t   line  = 0;
+    };
+
+    std::string                                      m_text;
+    uint64_t                                         m_hash = 0;
+    std::vector<std::string>                         m_files;
+    std::vector<Segment>                             m_segments;
+    std::vector<std::pair<std::string, SourceStamp>> m_inputs;
+};
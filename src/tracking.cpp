@@ -0,0 +1,61 @@
+#include "tracking.hpp"
+
+#include <unordered_set>
+
+uint64_t ChangeTracker::generation() const {
+    return m_generation;
+}
+
+uint64_t ChangeTracker::keyGeneration(std::string_view key) const {
+    if (auto it = m_keys.find(key); it != m_keys.end())
+        return it->second;
+    return m_allGeneration;
+}
+
+void ChangeTracker::markAll() {
+    m_allGeneration = ++m_generation;
+    m_keys.clear();
+    m_log.clear();
+}
+
+void ChangeTracker::markKey(std::string_view key) {
+    ++m_generation;
+    if (auto it = m_keys.find(key); it != m_keys.end())
+        it->second = m_generation;
+    else
+        m_keys.emplace(key, m_generation);
+
+    if (m_log.size() == LOG_SIZE) {
+        m_logDropped = m_log.front().first;
+        m_log.pop_front();
+    }
+    m_log.emplace_back(m_generation, key);
+}
+
+std::optional<std::vector<std::string_view>> ChangeTracker::changedSince(uint64_t since) const {
+    if (since < m_allGeneration || since < m_logDropped)
+        return std::nullopt;
+
+    std::vector<std::string_view>        keys;
+    std::unordered_set<std::string_view> seen;
+    for (auto it = m_log.rbegin(); it != m_log.rend() && it->first > since; ++it) {
+        if (seen.insert(it->second).second)
+            keys.push_back(it->second);
+    }
+    return keys;
+}
+
+static std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+        s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r' || s.back() == '\n'))
+        s.remove_suffix(1);
+    return s;
+}
+
+std::pair<std::string_view, std::string_view> splitDynamicLine(std::string_view line) {
+    const auto eq = line.find('=');
+    if (eq == std::string_view::npos)
+        return {{}, trim(line)};
+    return {trim(line.substr(0, eq)), trim(line.substr(eq + 1))};
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Change generations of a config. The generation starts at 0 and is bumped
+// by every successful change. A full parse, or a structural change such as a
+// special category being added or removed, may touch any key and moves every
+// key to the new generation; a dynamic change moves only its own key.
+// Dynamic changes are also kept in a bounded log, so pollers can ask which
+// keys changed since a generation in time proportional to the answer.
+class ChangeTracker {
+  public:
+    uint64_t generation() const;
+
+    // Generation of the last change that could have touched `key`.
+    uint64_t keyGeneration(std::string_view key) const;
+
+    void     markAll();
+    void     markKey(std::string_view key);
+
+    // Keys changed after generation `since`, each once, most recent first.
+    // nullopt if that cannot be answered from the log (a full change happened
+    // since, or the log no longer reaches back that far), in which case the
+    // caller has to treat every key as changed.
+    std::optional<std::vector<std::string_view>> changedSince(uint64_t since) const;
+
+    static constexpr size_t LOG_SIZE = 1024;
+
+  private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const {
+            return std::hash<std::string_view>{}(s);
+        }
+    };
+
+    uint64_t                                                              m_generation    = 0;
+    uint64_t                                                              m_allGeneration = 0;
+    std::unordered_map<std::string, uint64_t, StringHash, std::equal_to<>> m_keys; // keys changed since m_allGeneration
+    std::deque<std::pair<uint64_t, std::string>>                          m_log;
+    uint64_t                                                              m_logDropped = 0; // generation of the newest entry dropped from the log
+};
+
+// Key and value of a dynamic `key = value` line, both trimmed. The key is
+// empty if the line has no '='.
+std::pair<std::string_view, std::string_view> splitDynamicLine(std::string_view line);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <hyprlang.hpp>
+#include <any>
+#include <cstdint>
+#include <string>
+
+// Type tag of a config value, matching the types hyprlang stores.
+enum class ValueType : uint8_t {
+    EMPTY = 0,
+    INT,
+    FLOAT,
+    STRING,
+    VEC2,
+    CUSTOM,
+};
+
+inline ValueType valueTypeOf(const std::any& val) {
+    if (!val.has_value())
+        return ValueType::EMPTY;
+
+    const auto& t = val.type();
+    if (t == typeid(int64_t))
+        return ValueType::INT;
+    if (t == typeid(float))
+        return ValueType::FLOAT;
+    if (t == typeid(const char*))
+        return ValueType::STRING;
+    if (t == typeid(Hyprlang::SVector2D))
+        return ValueType::VEC2;
+    if (t == typeid(void*))
+        return ValueType::CUSTOM;
+    return ValueType::EMPTY;
+}
+
+// A value to register and its default, in a form that can be applied to a
+// CConfig without touching Python objects.
+struct SchemaEntry {
+    std::string         name;
+    ValueType           type = ValueType::EMPTY;
+    int64_t             i    = 0;
+    float               f    = 0;
+    Hyprlang::SVector2D vec;
+    std::string         str;
+};
+
+inline void addSchemaEntry(Hyprlang::CConfig& config, const SchemaEntry& entry) {
+    switch (entry.type) {
+        case ValueType::INT: config.addConfigValue(entry.name.c_str(), Hyprlang::CConfigValue((Hyprlang::INT)entry.i)); break;
+        case ValueType::FLOAT: config.addConfigValue(entry.name.c_str(), Hyprlang::CConfigValue((Hyprlang::FLOAT)entry.f)); break;
+        case ValueType::STRING: config.addConfigValue(entry.name.c_str(), Hyprlang::CConfigValue((Hyprlang::STRING)entry.str.c_str())); break;
+        case ValueType::VEC2: config.addConfigValue(entry.name.c_str(), Hyprlang::CConfigValue(entry.vec)); break;
+        default: break;
+    }
+}
@@ -0,0 +1,30 @@
+#include "variables.hpp"
+
+#include <stdexcept>
+
+static bool isNameChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+std::vector<std::string> variableLines(const std::vector<std::pair<std::string, std::string>>& variables) {
+    std::vector<std::string> lines;
+    for (const auto& [name, value] : variables) {
+        if (name.empty())
+            throw std::invalid_argument("Variable names cannot be empty");
+        for (char c : name) {
+            if (!isNameChar(c))
+                throw std::invalid_argument("Invalid variable name: " + name);
+        }
+        if (value.find_first_of("\r\n") != std::string::npos)
+            throw std::invalid_argument("Value of $" + name + " spans several lines");
+
+        auto& line = lines.emplace_back("$" + name + " = ");
+        for (char c : value) {
+            // a lone # would start a comment
+            if (c == '#')
+                line += '#';
+            line += c;
+        }
+    }
+    return lines;
+}
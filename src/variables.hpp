@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// One `$NAME = value` line per entry of `variables`, in order, for
+// parseDynamic(). Names must be non-empty and made of letters, digits and '_';
+// values must fit on one line, and '#' in them is escaped. Throws std::invalid_argument otherwise.
+std::vector<std::string> variableLines(const std::vector<std::pair<std::string, std::string>>& variables);
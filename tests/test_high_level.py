@@ -1,6 +1,12 @@
 """Tests for the high-level Pythonic API."""
 
+import io
+import json
 import os
+import pickle
+import struct
+import subprocess
+import sys
 import pytest
 import hyprlang_pybind as hyprlang
 
@@ -70,6 +76,87 @@ class TestParseString:
         )
         assert data["color"] == 0xFF0000
 
+    def test_bytes_like(self, tmp_path):
+        text = b"general {\n  border = 5\n  gap = 10.0\n}\nlayout = dwindle\n"
+        expected = hyprlang.parse_string(text.decode())
+        assert hyprlang.parse_string(text) == expected
+        assert hyprlang.parse_string(bytearray(text)) == expected
+        assert hyprlang.parse_string(memoryview(text)[:-1]) == expected
+
+        import mmap
+
+        path = tmp_path / "mapped.conf"
+        path.write_bytes(text)
+        with open(path, "rb") as f, mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as m:
+            assert hyprlang.parse_string(m) == expected
+
+    def test_inferred_schema(self):
+        from hyprlang_pybind._core import infer_schema
+
+        assert infer_schema(
+            b"a = true\nb = 0x1F\nc = rgba(1, 2, 3, 1.0)\nd = .5\ne = 1 2\n"
+            b"cat {\n  f = x # comment\n}\n$V = 1\nsource = other.conf\n"
+        ) == [("a", 0), ("b", 0), ("c", 0), ("d", 0.0), ("e", (0.0, 0.0)), ("cat:f", "")]
+
+
+class TestParseCache:
+    def teardown_method(self):
+        hyprlang.disable_parse_cache()
+
+    def test_hits(self):
+        text = "general:gap = 4\nname = x\n"
+        assert hyprlang.parse_cache_stats() is None
+        hyprlang.enable_parse_cache()
+        first = hyprlang.parse_string(text)
+        first["general"]["gap"] = 99
+        second = hyprlang.parse_string(text)
+        assert second == {"general": {"gap": 4}, "name": "x"}
+
+        stats = hyprlang.parse_cache_stats()
+        assert (stats["hits"], stats["misses"], stats["entries"]) == (1, 1, 1)
+
+        # a different schema is a different entry
+        hyprlang.parse_string(text, {"general": {"gap": 0.0}, "name": ""})
+        assert hyprlang.parse_cache_stats()["entries"] == 2
+
+    def test_file_revalidated(self, tmp_path):
+        hyprlang.enable_parse_cache()
+        inc = tmp_path / "inc.conf"
+        inc.write_text("a = 1\n")
+        root = tmp_path / "root.conf"
+        root.write_text("source = inc.conf\n")
+        assert hyprlang.parse_file(str(root), {"a": 0}) == {"a": 1}
+        assert hyprlang.parse_file(str(root), {"a": 0}) == {"a": 1}
+        inc.write_text("a = 2\n")
+        assert hyprlang.parse_file(str(root), {"a": 0}) == {"a": 2}
+
+    def test_file_revalidated_by_stamp(self, tmp_path):
+        hyprlang.enable_parse_cache()
+        root = tmp_path / "root.conf"
+        root.write_text("a = 1\n")
+        os.utime(root, (1_000_000_000, 1_000_000_000))
+        assert hyprlang.parse_file(str(root), {"a": 0}) == {"a": 1}
+        assert hyprlang.parse_file(str(root), {"a": 0}) == {"a": 1}
+        assert hyprlang.parse_cache_stats()["hits"] == 1
+        root.write_text("a = 3\n")
+        assert hyprlang.parse_file(str(root), {"a": 0}) == {"a": 3}
+
+    def test_missing_file(self, tmp_path):
+        missing = str(tmp_path / "missing.conf")
+        with pytest.raises(FileNotFoundError) as uncached:
+            hyprlang.parse_file(missing)
+        hyprlang.enable_parse_cache()
+        with pytest.raises(FileNotFoundError) as cached:
+            hyprlang.parse_file(missing)
+        assert str(cached.value) == str(uncached.value)
+        assert cached.value.filename == missing
+
+    def test_errors_not_cached(self):
+        hyprlang.enable_parse_cache()
+        with pytest.raises(hyprlang.HyprlangError):
+            hyprlang.parse_string("a = 1\nb = 2\n", {"a": 0})
+        assert hyprlang.parse_cache_stats()["entries"] == 0
+
 
 class TestParseFile:
     def test_basic(self):
@@ -92,6 +179,266 @@ class TestParseFile:
         assert data["testCategory"]["innerString"] == "nested value"
 
 
+class TestVariables:
+    TEMPLATE = "general:gap = $GAP\ngeneral:name = $NAME\n"
+    SCHEMA = {"general": {"gap": 0, "name": ""}}
+
+    def test_parse_string(self):
+        for gap in (1, 10):
+            data = hyprlang.parse_string(
+                self.TEMPLATE, self.SCHEMA, variables={"GAP": gap, "NAME": "a # b"}
+            )
+            assert data["general"] == {"gap": gap, "name": "a # b"}
+
+    def test_set_variables_replaces(self):
+        config = hyprlang.Config(self.TEMPLATE, is_stream=True, variables={})
+        config.add("general:gap", 0)
+        config.add("general:name", "")
+        config.commence()
+        config.set_variables({"GAP": 3, "NAME": "x"})
+        config.parse()
+        assert config["general:gap"] == 3
+        config.set_variables({"GAP": 4, "NAME": "y"})
+        config.parse()
+        assert config["general:name"] == "y"
+
+    def test_file_root(self, tmp_path):
+        path = tmp_path / "host.conf"
+        path.write_text(self.TEMPLATE)
+        config = hyprlang.Config(str(path), variables={})
+        config.add("general:gap", 0)
+        config.add("general:name", "")
+        config.commence()
+        config.set_variables({"GAP": 7, "NAME": "n"})
+        config.parse()
+        assert config["general:gap"] == 7
+
+        plain = hyprlang.Config(str(path))
+        with pytest.raises(hyprlang.HyprlangError):
+            plain.set_variables({"GAP": 1})
+
+    def test_invalid(self):
+        config = hyprlang.Config("a = 1", is_stream=True, variables={})
+        with pytest.raises(hyprlang.HyprlangError):
+            config.set_variables({"bad name": 1})
+        with pytest.raises(hyprlang.HyprlangError):
+            config.set_variables({"OK": "two\nlines"})
+
+        plain = hyprlang.Config("a = 1", is_stream=True)
+        with pytest.raises(hyprlang.HyprlangError):
+            plain.set_variables({"OK": 1})
+
+    def test_stream_reparse(self, tmp_path, monkeypatch):
+        (tmp_path / "inc.conf").write_text("general:name = $NAME\n")
+        monkeypatch.chdir(tmp_path)
+        config = hyprlang.Config(
+            "general:gap = $GAP\nsource = inc.conf\n", is_stream=True, variables={}
+        )
+        config.add("general:gap", 0)
+        config.add("general:name", "")
+        config.commence()
+        for gap in (1, 2):
+            config.set_variables({"GAP": gap, "NAME": f"n{gap}"})
+            config.parse()
+            assert config["general:gap"] == gap
+            assert config["general:name"] == f"n{gap}"
+
+
+class TestPrefetch:
+    def test_same_result(self, tmp_path):
+        for i in range(4):
+            (tmp_path / f"part{i}.conf").write_text(f"general:v{i} = {i}\n")
+        root = tmp_path / "root.conf"
+        root.write_text("".join(f"source = part{i}.conf\n" for i in range(4)))
+        schema = {"general": {f"v{i}": 0 for i in range(4)}}
+
+        expected = hyprlang.parse_file(str(root), schema)
+        assert hyprlang.parse_file(str(root), schema, prefetch=4) == expected
+        assert expected["general"]["v3"] == 3
+
+    def test_missing_include(self, tmp_path):
+        root = tmp_path / "root.conf"
+        root.write_text("source = nope.conf\n")
+        config = hyprlang.Config(str(root), prefetch=2)
+        config.commence()
+        with pytest.raises(hyprlang.HyprlangError):
+            config.parse()
+
+
+class TestSourceCache:
+    def test_shared_between_configs(self, tmp_path):
+        colors = tmp_path / "colors.conf"
+        colors.write_text("general:accent = 7\n")
+        schema = {"general": {"accent": 0, "gap": 0}}
+        paths = []
+        for i in range(3):
+            path = tmp_path / f"user{i}.conf"
+            path.write_text(f"source = colors.conf\ngeneral:gap = {i}\n")
+            paths.append(str(path))
+
+        hyprlang.clear_source_cache()
+        before = hyprlang.source_cache_stats()
+        results = [hyprlang.parse_file(p, schema, source_cache=True) for p in paths]
+        assert [r["general"] for r in results] == [
+            {"accent": 7, "gap": i} for i in range(3)
+        ]
+        stats = hyprlang.source_cache_stats()
+        assert stats["hits"] - before["hits"] >= 2
+        assert stats["entries"] == 4
+
+    def test_edited_file_is_reread(self, tmp_path):
+        inc = tmp_path / "inc.conf"
+        inc.write_text("a = 1\n")
+        root = tmp_path / "root.conf"
+        root.write_text("source = inc.conf\n")
+        assert hyprlang.parse_file(str(root), {"a": 0}, source_cache=True) == {"a": 1}
+        inc.write_text("a = 22\n")
+        assert hyprlang.parse_file(str(root), {"a": 0}, source_cache=True) == {"a": 22}
+
+    def test_reparse_starts_from_defaults(self, tmp_path):
+        root = tmp_path / "root.conf"
+        root.write_text("a = 5\n")
+        config = hyprlang.Config(str(root), source_cache=True)
+        config.add("a", 0)
+        config.commence()
+        config.parse()
+        assert config["a"] == 5
+        root.write_text("\n")
+        config.parse()
+        assert config["a"] == 0
+
+    def test_error_names_the_included_file(self, tmp_path):
+        inc = tmp_path / "inc.conf"
+        inc.write_text("a = 1\nnope = 2\n")
+        root = tmp_path / "root.conf"
+        root.write_text("a = 0\nsource = inc.conf\n")
+        with pytest.raises(hyprlang.HyprlangError) as info:
+            hyprlang.parse_file(str(root), {"a": 0}, source_cache=True)
+        message = str(info.value)
+        assert "/proc/self/fd/" not in message
+        assert str(inc.resolve()) in message
+        assert "line 2" in message
+
+    def test_source_loop(self, tmp_path):
+        loop = tmp_path / "loop.conf"
+        loop.write_text("source = loop.conf\n")
+        with pytest.raises(hyprlang.HyprlangError):
+            hyprlang.parse_file(str(loop), {}, source_cache=True)
+
+
+class TestBundle:
+    def make_tree(self, tmp_path):
+        (tmp_path / "colors.conf").write_text("general:accent = 7\n")
+        root = tmp_path / "root.conf"
+        root.write_text("general:gap = 1\nsource = colors.conf\ngeneral:border = 3\n")
+        return root
+
+    def test_round_trip(self, tmp_path):
+        b = hyprlang.bundle(str(self.make_tree(tmp_path)))
+        assert len(b.files) == 2
+        assert b.text.startswith("# hyprlang bundle ")
+        assert hyprlang.bundle(str(tmp_path / "root.conf")) is b
+
+        config = hyprlang.Config.from_bundle(b.text)
+        for key in ("general:gap", "general:accent", "general:border"):
+            config.add(key, 0)
+        config.commence()
+        config.parse()
+        assert config.to_dict() == {"general": {"gap": 1, "accent": 7, "border": 3}}
+
+    def test_origin_and_errors(self, tmp_path):
+        b = hyprlang.bundle(str(self.make_tree(tmp_path)))
+        lines = b.text.splitlines()
+        accent = lines.index("general:accent = 7") + 1
+        assert b.origin(accent) == (str((tmp_path / "colors.conf").resolve()), 1)
+        assert b.origin(1) is None
+
+        (tmp_path / "colors.conf").write_text("general:accent = 7\nbogus = 1\n")
+        assert not b.is_current()
+        config = hyprlang.Config.from_bundle(hyprlang.bundle(str(tmp_path / "root.conf")))
+        config.add("general:accent", 0)
+        config.commence()
+        with pytest.raises(hyprlang.HyprlangError, match="colors.conf:2"):
+            config.parse()
+
+    def test_marker_like_comment(self, tmp_path):
+        root = tmp_path / "root.conf"
+        root.write_text("#@ 5 /elsewhere.conf\na = 1\n")
+        b = hyprlang.bundle(str(root))
+        assert b.files == [str(root.resolve())]
+        assert b.origin(b.text.splitlines().index("a = 1") + 1) == (str(root.resolve()), 2)
+
+        config = hyprlang.Config.from_bundle(b)
+        config.add("a", 0)
+        config.commence()
+        config.parse()
+        assert config["a"] == 1
+
+    def test_corrupt_text(self, tmp_path):
+        b = hyprlang.bundle(str(self.make_tree(tmp_path)))
+        with pytest.raises(hyprlang.HyprlangError):
+            hyprlang.Config.from_bundle(b.text + "general:gap = 9\n")
+
+
+class TestLimits:
+    def test_within_limits(self):
+        data = hyprlang.parse_string(
+            "a = 1\nb = 2\n", max_bytes=64, max_lines=2, timeout=5.0
+        )
+        assert data == {"a": 1, "b": 2}
+
+    def test_max_bytes_and_lines(self):
+        text = "a = 1\n" * 100
+        with pytest.raises(hyprlang.HyprlangLimitError):
+            hyprlang.parse_string(text, schema={"a": 0}, max_bytes=64)
+        with pytest.raises(hyprlang.HyprlangLimitError):
+            hyprlang.parse_string(text, schema={"a": 0}, max_lines=10)
+
+    def test_include_depth(self, tmp_path):
+        inner = tmp_path / "inner.conf"
+        inner.write_text("a = 2\n")
+        middle = tmp_path / "middle.conf"
+        middle.write_text(f"source = {inner}\n")
+        root = tmp_path / "root.conf"
+        root.write_text(f"source = {middle}\n")
+
+        assert hyprlang.parse_file(str(root), {"a": 0}, max_include_depth=2) == {"a": 2}
+        with pytest.raises(hyprlang.HyprlangLimitError):
+            hyprlang.parse_file(str(root), {"a": 0}, max_include_depth=1)
+
+    def test_source_loop(self, tmp_path):
+        loop = tmp_path / "loop.conf"
+        loop.write_text(f"a = 1\nsource = {loop}\n")
+        config = hyprlang.Config(str(loop), max_include_depth=8)
+        config.add("a", 0)
+        config.commence()
+        with pytest.raises(hyprlang.HyprlangError):
+            config.parse()
+
+    def test_source_loop_without_depth_limit(self, tmp_path):
+        first = tmp_path / "first.conf"
+        second = tmp_path / "second.conf"
+        first.write_text(f"a = 1\nsource = {second}\n")
+        second.write_text(f"source = {first}\n")
+        with pytest.raises(hyprlang.HyprlangLimitError, match="loop"):
+            hyprlang.parse_file(str(first), {"a": 0}, timeout=5.0)
+
+    def test_variable_source_rejected(self, tmp_path):
+        big = tmp_path / "big.conf"
+        big.write_text("a = 1\n" * 100)
+        text = f"$X = {big}\nsource = $X\n"
+        with pytest.raises(hyprlang.HyprlangLimitError, match="cannot be checked"):
+            hyprlang.parse_string(text, {"a": 0}, max_bytes=64)
+        assert hyprlang.parse_string(text, {"a": 0}) == {"a": 1}
+
+    def test_shared_include_is_not_a_loop(self, tmp_path):
+        common = tmp_path / "common.conf"
+        common.write_text("a = 2\n")
+        root = tmp_path / "root.conf"
+        root.write_text(f"source = {common}\nsource = {common}\n")
+        assert hyprlang.parse_file(str(root), {"a": 0}, max_lines=10) == {"a": 2}
+
+
 class TestConfigClass:
     def test_basic_usage(self):
         config = hyprlang.Config(
@@ -158,6 +505,241 @@ class TestConfigClass:
             config.commence()
             config.parse()
 
+    def test_tuple_paths(self):
+        config = hyprlang.Config(
+            "general {\n  border = 5\n  snap {\n    enabled = true\n  }\n}\n",
+            is_stream=True,
+        )
+        config.add("general:border", 0)
+        config.add("general:snap:enabled", 0)
+        config.commence()
+        config.parse()
+
+        path = ("general", "snap", "enabled")
+        for _ in range(3):
+            assert config.get(path) == 1
+            assert config[path] == 1
+        assert config.is_set_by_user(("general", "border")) is True
+        assert ("general", "missing") not in config
+        assert config.get_values([("general", "border"), "general:snap:enabled", ("nope",)]) == [5, 1, None]
+        with pytest.raises(KeyError):
+            config[("general", "missing")]
+        with pytest.raises(TypeError):
+            config.get(("general", 1))
+
+        snap = config.snapshot()
+        assert snap[path] == 1
+        assert snap.get_values([path, ("general", "border")]) == [1, 5]
+
+    def test_tuple_paths_built_per_lookup(self):
+        config = hyprlang.Config("a = 1\nb = 2", is_stream=True)
+        config.add("a", 0)
+        config.add("b", 0)
+        config.commence()
+        config.parse()
+
+        class Path(tuple):
+            pass
+
+        class Part(str):
+            pass
+
+        # fresh equal tuples share a cache entry; far more of them than it
+        # holds must keep resolving correctly as old entries are evicted
+        for i in range(10000):
+            name = "ab"[i % 2]
+            assert config[tuple([name])] == i % 2 + 1
+            assert config.get((f"k{i}",)) is None
+        assert config[Path(("b",))] == 2
+        assert config[(Part("a"),)] == 1
+
+    def test_generation(self):
+        config = hyprlang.Config("a = 1\nb = 2", is_stream=True)
+        config.add("a", 0)
+        config.add("b", 0)
+        config.commence()
+        assert config.generation == 0
+        config.parse()
+        parsed = config.generation
+        assert parsed == 1
+        assert config.key_generation("a") == config.key_generation("b") == parsed
+
+        config.parse_dynamic("a = 5")
+        assert config.generation == parsed + 1
+        assert config.key_generation("a") == parsed + 1
+        assert config.key_generation(("b",)) == parsed
+
+        with pytest.raises(hyprlang.HyprlangError):
+            config.parse_dynamic("missing = 1")
+        assert config.generation == parsed + 1
+
+    def test_special_changes_bump_generation(self):
+        config = hyprlang.Config("a = 1", is_stream=True)
+        config.add("a", 0)
+        config.add_special_category("device", key="name")
+        config.commence()
+        config.parse()
+        token = config.generation
+        config.add_special_value("device", "sens", 0.0)
+        assert config.generation == token + 1
+        assert config.changes_since(token) == (config.generation, None)
+
+    def test_changes_since(self):
+        config = hyprlang.Config("a = 1\nb = 2\nc = 3", is_stream=True)
+        for key in "abc":
+            config.add(key, 0)
+        config.commence()
+        config.parse()
+
+        token = config.generation
+        assert config.changes_since(token) is None
+
+        config.parse_dynamic("a = 5")
+        config.parse_dynamic("b = 6")
+        config.parse_dynamic("a = 7")
+        token, keys = config.changes_since(token)
+        assert token == config.generation
+        assert keys == ["a", "b"]
+        assert config.changes_since(token) is None
+
+        config.parse()
+        assert config.changes_since(token) == (config.generation, None)
+
+    def test_journal(self):
+        config = hyprlang.Config("a = 1\nb = 2", is_stream=True, journal_size=2)
+        config.add("a", 0)
+        config.add("b", 0)
+        config.commence()
+        config.parse()
+        assert config.journal.last_seq == 0
+        assert config.journal.since(0) == []
+
+        config.parse_dynamic("a = 5")
+        with pytest.raises(hyprlang.HyprlangError):
+            config.parse_dynamic("missing = 1")
+        entries = config.journal.since(0)
+        assert [(e.seq, e.command, e.value, e.ok) for e in entries] == [(1, "a", "5", True), (2, "missing", "1", False)]
+        assert entries[1].error
+        assert entries[0].timestamp > 0
+
+        config.raw.parse_dynamic_kv("b", "9")
+        assert config.journal.since(0) is None
+        assert [e.seq for e in config.journal.since(1)] == [2, 3]
+        assert config.journal.since(3) == []
+
+        assert hyprlang.Config("a = 1", is_stream=True).journal is None
+
+    def test_attrs(self):
+        config = hyprlang.Config(
+            "general {\n  border = 5\n  snap {\n    enabled = true\n  }\n}\nname = x\n",
+            is_stream=True,
+        )
+        config.add("general:border", 0)
+        config.add("general:snap:enabled", 0)
+        config.add("name", "")
+        with pytest.raises(hyprlang.HyprlangError):
+            config.attrs
+        config.commence()
+        config.parse()
+
+        attrs = config.attrs
+        assert attrs is config.attrs
+        assert attrs.general.border == 5
+        assert attrs.general.snap.enabled == 1
+        assert attrs.name == "x"
+        config.parse_dynamic("general:border = 8")
+        assert attrs.general.border == 8
+        with pytest.raises(AttributeError):
+            attrs.general.border = 1
+        with pytest.raises(AttributeError):
+            attrs.general.missing
+
+    @pytest.mark.parametrize("keys", [("a", "a:b"), ("a:b", "a")])
+    def test_attrs_value_and_category(self, keys):
+        config = hyprlang.Config("a = 1", is_stream=True)
+        for key in keys:
+            config.add(key, 0)
+        config.commence()
+        config.parse()
+        with pytest.raises(hyprlang.HyprlangError, match="both a value and a category"):
+            config.attrs
+        assert config["a"] == 1
+
+    def test_get_category(self):
+        config = hyprlang.Config(
+            "decoration:rounding = 8\ndecoration:blur:enabled = 1\n", is_stream=True
+        )
+        config.add("decoration:rounding", 0)
+        config.add("decoration:blur:enabled", 0)
+        config.add("decorations:other", 0)
+        config.add("general:snap:enabled", 0)
+        with pytest.raises(hyprlang.HyprlangError):
+            config.get_category("decoration")
+        config.commence()
+        config.parse()
+
+        assert config.get_category("decoration") == {
+            "rounding": 8,
+            "blur": {"enabled": 1},
+        }
+        assert config.get_category("decoration:blur", nested=False) == {
+            "decoration:blur:enabled": 1
+        }
+        assert config.get_category("missing") == {}
+        assert config.get_matching("*:enabled") == {
+            "decoration:blur:enabled": 1,
+            "general:snap:enabled": 0,
+        }
+        assert list(config.get_matching("decoration*")) == [
+            "decoration:blur:enabled",
+            "decoration:rounding",
+            "decorations:other",
+        ]
+
+    def test_keys_items_types(self):
+        config = hyprlang.Config("a = 3\nc = 1.5\n", is_stream=True)
+        config.add("a", 0)
+        config.add("b", "x")
+        config.raw.add_value("c", 0.0)
+        config.add("d", (1.0, 2.0))
+        config.commence()
+        config.parse()
+
+        assert config.keys() == ["a", "b", "c", "d"]
+        assert config.items() == [("a", 3), ("b", "x"), ("c", 1.5), ("d", (1.0, 2.0))]
+        assert config.types() == {
+            "a": hyprlang.ValueType.INT,
+            "b": hyprlang.ValueType.STRING,
+            "c": hyprlang.ValueType.FLOAT,
+            "d": hyprlang.ValueType.VEC2,
+        }
+        assert config.to_dict()["c"] == 1.5
+
+    def test_export_columns(self):
+        config = hyprlang.Config("a = 3\nb = y\nv = 1 2\n", is_stream=True)
+        for i in range(7):
+            config.add(f"pad{i}", i)
+        config.add("a", 0)
+        config.add("b", "x")
+        config.add("f", 0.5)
+        config.add("v", (0.0, 0.0))
+        config.commence()
+        config.parse()
+
+        cols = config.export_columns()
+        assert cols["keys"] == [*(f"pad{i}" for i in range(7)), "a", "b", "f", "v"]
+        assert cols["set_by_user"] == bytes([0x80, 0x05])
+        rows, values = cols["int"]
+        assert rows.tolist() == [*range(8)]
+        assert values.tolist() == [*range(7), 3]
+        rows, values = cols["float"]
+        assert (rows.tolist(), values.tolist()) == ([9], [0.5])
+        rows, values = cols["string"]
+        assert (rows.tolist(), values) == ([8], ["y"])
+        rows, values = cols["vec2"]
+        assert (rows.tolist(), values.tolist()) == ([10], [1.0, 2.0])
+        assert cols["other"].tolist() == []
+
     def test_contains(self):
         config = hyprlang.Config("x = 1", is_stream=True)
         config.add("x", 0)
@@ -180,6 +762,432 @@ class TestConfigClass:
         assert config.raw.get_value("x") == 1
 
 
+class TestJson:
+    def make_config(self):
+        config = hyprlang.Config(
+            'cat {\n  n = 3\n  f = 0.1\n  s = say "hi"\n}\n'
+            "v = 1.5 -2\ncolor = rgba(255, 0, 0, 1.0)",
+            is_stream=True,
+        )
+        config.add("cat:n", 0)
+        config.add("cat:f", 0.0)
+        config.add("cat:s", "")
+        config.add("v", (0.0, 0.0))
+        config.add("color", 0)
+        config.commence()
+        config.parse()
+        return config
+
+    def test_values(self):
+        config = self.make_config()
+        data = json.loads(config.to_json())
+        assert data["cat"]["n"] == 3
+        # floats are written at 32-bit precision; to_dict() widens them
+        assert data["cat"]["f"] == 0.1
+        assert struct.unpack("f", struct.pack("f", data["cat"]["f"]))[0] == config["cat:f"]
+        assert data["cat"]["s"] == 'say "hi"'
+        assert data["v"] == [1.5, -2.0]
+        assert data["color"] == config["color"]
+
+    def test_vec2_shortest_form(self):
+        config = hyprlang.Config("v = 0.1 -2.3", is_stream=True)
+        config.add("v", (0.0, 0.0))
+        config.commence()
+        config.parse()
+        assert '"v": [0.1, -2.3]' in config.to_json()
+        assert config.to_json() == config.snapshot().to_json()
+
+    def test_indent_matches_json_dumps(self):
+        config = hyprlang.Config("a = 1\nb:c = x", is_stream=True)
+        config.add("a", 0)
+        config.add("b:c", "")
+        config.commence()
+        config.parse()
+        expected = {"a": 1, "b": {"c": "x"}}
+        assert config.to_json() == json.dumps(expected)
+        assert config.to_json(indent=2) == json.dumps(expected, indent=2)
+
+    def test_non_finite_floats(self):
+        config = hyprlang.Config("x = 1", is_stream=True)
+        config.add("x", 0)
+        config.add("f", float("inf"))
+        config.commence()
+        config.parse()
+        with pytest.raises(ValueError):
+            config.to_json()
+        with pytest.raises(ValueError):
+            config.snapshot().to_json()
+        assert json.loads(config.to_json(allow_nan=True))["f"] == float("inf")
+
+    def test_write_json_and_snapshot(self):
+        config = self.make_config()
+        buf = io.StringIO()
+        config.write_json(buf)
+        assert buf.getvalue() == config.to_json()
+        assert json.loads(config.snapshot().to_json()) == json.loads(buf.getvalue())
+
+
+class TestCompiled:
+    def make_config(self, path):
+        config = hyprlang.Config(str(path))
+        config.add("general:gap", 0)
+        config.add("general:name", "")
+        config.add("unset", 7)
+        config.add_special_category("device", key="key")
+        config.add_special_value("device", "sens", 0.0)
+        config.commence()
+        config.parse()
+        return config
+
+    def test_round_trip(self, tmp_path):
+        conf = tmp_path / "a.conf"
+        conf.write_text(
+            "general {\n  gap = 5\n  name = hi\n}\n"
+            "device[mouse] {\n  sens = 0.5\n}\n"
+        )
+        out = tmp_path / "a.bin"
+        self.make_config(conf).save_compiled(str(out))
+
+        snap = hyprlang.load_compiled(str(out))
+        assert snap is not None
+        assert snap["general:gap"] == 5
+        assert snap["general:name"] == "hi"
+        assert snap.is_set_by_user("general:gap") is True
+        assert snap.is_set_by_user("unset") is False
+        assert snap.get("missing", 1) == 1
+        assert abs(snap.get_special("device", "sens", "mouse") - 0.5) < 0.01
+        assert snap.list_special_keys("device") == ["mouse"]
+        assert snap.to_dict() == {"general": {"gap": 5, "name": "hi"}, "unset": 7}
+        assert snap.sources == [str(conf)]
+
+    def test_stale_source(self, tmp_path):
+        inc = tmp_path / "inc.conf"
+        inc.write_text("general:gap = 1\n")
+        conf = tmp_path / "a.conf"
+        conf.write_text(f"source = {inc.name}\n")
+        out = tmp_path / "a.bin"
+        self.make_config(conf).save_compiled(str(out))
+
+        assert hyprlang.load_compiled(str(out)) is not None
+        inc.write_text("general:gap = 2\n")
+        assert hyprlang.load_compiled(str(out)) is None
+        assert hyprlang.load_compiled(str(out), validate=False)["general:gap"] == 1
+
+    def test_save_leaves_no_temp_files(self, tmp_path):
+        conf = tmp_path / "a.conf"
+        conf.write_text("general:gap = 1\n")
+        config = self.make_config(conf)
+        config.save_compiled(str(tmp_path / "a.bin"))
+        assert sorted(p.name for p in tmp_path.iterdir()) == ["a.bin", "a.conf"]
+
+        # the rename onto a non-empty directory fails after the write
+        busy = tmp_path / "busy"
+        busy.mkdir()
+        (busy / "x").write_text("")
+        with pytest.raises(RuntimeError):
+            config.save_compiled(str(busy))
+        assert sorted(p.name for p in tmp_path.iterdir()) == ["a.bin", "a.conf", "busy"]
+
+    def test_invalid_file(self, tmp_path):
+        bad = tmp_path / "bad.bin"
+        bad.write_bytes(b"not a snapshot at all" * 8)
+        with pytest.raises(hyprlang.HyprlangError):
+            hyprlang.load_compiled(str(bad))
+
+
+class TestSnapshotPickle:
+    def make_snapshot(self):
+        config = hyprlang.Config("a = 1\nb = text\nc = 1.5 2.5", is_stream=True)
+        config.add("a", 0)
+        config.add("b", "")
+        config.add("c", (0.0, 0.0))
+        config.commence()
+        config.parse()
+        return config.snapshot()
+
+    def test_round_trip(self):
+        snap = self.make_snapshot()
+        for protocol in (2, 4, 5):
+            copy = pickle.loads(pickle.dumps(snap, protocol=protocol))
+            assert copy.to_dict() == snap.to_dict()
+            assert copy.is_set_by_user("a") is True
+
+    def test_out_of_band(self):
+        snap = self.make_snapshot()
+        buffers = []
+        data = pickle.dumps(snap, protocol=5, buffer_callback=buffers.append)
+        assert len(buffers) == 1
+        assert buffers[0].raw().nbytes == snap.nbytes
+        copy = pickle.loads(data, buffers=buffers)
+        assert copy["b"] == "text"
+        assert copy["c"] == (1.5, 2.5)
+
+
+class TestSharedSnapshot:
+    def make_config(self, text):
+        config = hyprlang.Config(text, is_stream=True)
+        config.add("gap", 0)
+        config.commence()
+        config.parse()
+        return config
+
+    def test_publish_and_reload(self):
+        name = f"hyprlang-test-{os.getpid()}"
+        try:
+            assert hyprlang.publish_shared(name, self.make_config("gap = 1")) == 1
+            view = hyprlang.attach_shared(name)
+            assert view["gap"] == 1
+            old = view.snapshot()
+
+            assert hyprlang.publish_shared(name, self.make_config("gap = 2").snapshot()) == 2
+            assert view.generation == 2
+            assert view["gap"] == 2
+            assert old["gap"] == 1
+        finally:
+            hyprlang.unlink_shared(name)
+
+    @pytest.mark.skipif(not os.path.isdir("/dev/shm"), reason="needs /dev/shm")
+    def test_publish_over_leftover_segment(self):
+        # a publisher that died before bumping the generation leaves ".1" behind
+        name = f"hyprlang-stale-{os.getpid()}"
+        with open(f"/dev/shm/{name}.1", "wb") as f:
+            f.write(b"junk")
+        try:
+            assert hyprlang.publish_shared(name, self.make_config("gap = 3")) == 1
+            assert hyprlang.attach_shared(name)["gap"] == 3
+        finally:
+            hyprlang.unlink_shared(name)
+
+    def test_attach_missing(self):
+        with pytest.raises(hyprlang.HyprlangError):
+            hyprlang.attach_shared(f"hyprlang-missing-{os.getpid()}")
+
+
+class TestLayered:
+    def test_precedence_and_origin(self, tmp_path):
+        system = tmp_path / "system.conf"
+        site = tmp_path / "site.conf"
+        user = tmp_path / "user.conf"
+        system.write_text("a = 1\nb = 1\n")
+        site.write_text("b = 2\nc = site\n")
+        user.write_text("a = 3\n")
+
+        snap = hyprlang.layered(
+            [str(system), str(site), str(user)],
+            {"a": 0, "b": 0, "c": "", "d": 9},
+        )
+        assert snap.to_dict() == {"a": 3, "b": 2, "c": "site", "d": 9}
+        assert snap.origin("a") == 2
+        assert snap.origin("b") == 1
+        assert snap.origin("c") == 1
+        assert snap.origin("d") is None
+        assert snap.is_set_by_user("d") is False
+        assert snap.is_current()
+
+    def test_missing_and_errors(self, tmp_path):
+        base = tmp_path / "base.conf"
+        base.write_text("a = 1\n")
+        missing = str(tmp_path / "missing.conf")
+
+        snap = hyprlang.layered([str(base), missing], {"a": 0}, allow_missing=True)
+        assert snap["a"] == 1
+        with pytest.raises(hyprlang.HyprlangError, match="missing.conf"):
+            hyprlang.layered([str(base), missing], {"a": 0})
+
+    def test_many_layers(self, tmp_path):
+        paths = []
+        for i in range(300):
+            path = tmp_path / f"{i}.conf"
+            path.write_text(f"a = {i}\n" if i % 7 == 0 else "")
+            paths.append(str(path))
+        snap = hyprlang.layered(paths, {"a": 0})
+        assert snap["a"] == 294
+        assert snap.origin("a") == 294
+
+
+class TestOverlay:
+    def test_overrides_fall_through(self):
+        config = hyprlang.Config("a = 1\nb = hello\nc = 2.5", is_stream=True)
+        config.add("a", 0)
+        config.add("b", "")
+        config.add("c", 0.0)
+        config.add("d", 7)
+        config.commence()
+        config.parse()
+
+        first = config.overlay()
+        second = config.overlay()
+        assert first.base is second.base
+
+        first.parse_dynamic("a = 10")
+        first.parse_dynamic("b = world")
+        assert first["a"] == 10
+        assert first["b"] == "world"
+        assert first["c"] == 2.5
+        assert first.overrides == ["a", "b"]
+        assert first.is_set_by_user("a") is True
+        assert first.is_set_by_user("d") is False
+        assert first.to_dict() == {"a": 10, "b": "world", "c": 2.5, "d": 7}
+
+        assert second["a"] == 1
+        assert second.overrides == []
+        assert config["a"] == 1
+
+        with pytest.raises(hyprlang.HyprlangError):
+            first.parse_dynamic("missing = 1")
+
+
+class TestLiveConfig:
+    def test_reload_swaps_versions(self, tmp_path):
+        path = tmp_path / "live.conf"
+        path.write_text("gap = 1\n")
+        live = hyprlang.LiveConfig(str(path), {"gap": 0})
+        assert live.version == 1
+        pinned = live.pin()
+
+        path.write_text("gap = 2\n")
+        assert live.reload() == 2
+        assert live["gap"] == 2
+        assert pinned["gap"] == 1
+
+        path.write_text("gap = 3\nbogus line\n")
+        with pytest.raises(hyprlang.HyprlangError):
+            live.reload()
+        assert live.version == 2
+        assert live.get("gap") == 2
+
+    def test_concurrent_readers(self, tmp_path):
+        import threading
+
+        path = tmp_path / "live.conf"
+        path.write_text("a = 0\nb = 0\n")
+        live = hyprlang.LiveConfig(str(path))
+        stop = threading.Event()
+        torn = []
+
+        def reader():
+            while not stop.is_set():
+                snap = live.pin()
+                if snap["a"] != snap["b"]:
+                    torn.append((snap["a"], snap["b"]))
+
+        threads = [threading.Thread(target=reader) for _ in range(4)]
+        for t in threads:
+            t.start()
+        for i in range(1, 20):
+            path.write_text(f"a = {i}\nb = {i}\n")
+            live.reload()
+        stop.set()
+        for t in threads:
+            t.join()
+        assert torn == []
+        assert live["a"] == 19
+
+
+class TestConfigRegistry:
+    def test_lazy_load_and_eviction(self, tmp_path):
+        path = tmp_path / "carol.conf"
+        path.write_text("general {\n  border = 3\n}\n")
+        loads = []
+
+        def loader(tenant):
+            loads.append(tenant)
+            if tenant == "carol":
+                return str(path)
+            return f"general:border = {len(tenant)}\n".encode()
+
+        registry = hyprlang.ConfigRegistry({"general": {"border": 0}}, loader, max_entries=2)
+        assert "bob" not in registry
+        assert registry["bob"]["general:border"] == 3
+        assert registry.get("bob") is registry["bob"]
+        assert loads == ["bob"]
+
+        registry["alice"]
+        registry["carol"]
+        assert len(registry) <= 2
+        stats = registry.stats
+        assert stats["misses"] == 3
+        assert stats["hits"] == 2
+        assert stats["evictions"] >= 1
+        assert stats["nbytes"] > 0
+
+        assert registry.invalidate("carol") is True
+        registry["carol"]
+        assert loads.count("carol") == 2
+
+    def test_parse_error(self):
+        registry = hyprlang.ConfigRegistry({"x": 0}, lambda tenant: b"x = 1\nnot valid")
+        with pytest.raises(hyprlang.HyprlangError):
+            registry["t"]
+        assert "t" not in registry
+
+    def test_missing_file(self, tmp_path):
+        missing = str(tmp_path / "missing.conf")
+        registry = hyprlang.ConfigRegistry({"x": 0}, lambda tenant: missing)
+        with pytest.raises(hyprlang.HyprlangError, match="missing.conf"):
+            registry["t"]
+
+    def test_entry_budget_is_exact(self):
+        # 20 entries over 16 shards: the remainder goes to the first shards
+        registry = hyprlang.ConfigRegistry(
+            {"x": 0}, lambda tenant: b"x = 1", max_entries=20
+        )
+        for i in range(2000):
+            registry[f"t{i}"]
+        assert 16 < len(registry) <= 20
+
+
+class TestStartup:
+    # Best-of-N wall time for the first Config (loading _core included). The
+    # strict budget is only checked with HYPRLANG_PYBIND_TIMING=1; otherwise a
+    # generous bound still catches gross regressions on slow or loaded
+    # machines. benchmarks/bench_import.py reports it too.
+    FIRST_CONFIG_BUDGET = 0.05
+    FIRST_CONFIG_BOUND = 1.0
+
+    def run(self, code):
+        out = subprocess.run(
+            [sys.executable, "-c", code], capture_output=True, text=True, check=True
+        )
+        return out.stdout.strip()
+
+    def test_import_does_not_load_core(self):
+        out = self.run(
+            "import sys, hyprlang_pybind; "
+            "print('hyprlang_pybind._core' in sys.modules)"
+        )
+        assert out == "False"
+
+    def test_import_loads_only_the_package(self):
+        out = self.run(
+            "import sys; before = set(sys.modules); import hyprlang_pybind; "
+            "print(' '.join(sorted(set(sys.modules) - before)))"
+        )
+        # no _core, re, json, ... at import time
+        assert set(out.split()) - {"__future__"} == {"hyprlang_pybind"}
+
+    def test_low_level_names_resolve_lazily(self):
+        assert hyprlang.SVector2D(1.0, 2.0).x == 1.0
+        with pytest.raises(AttributeError):
+            hyprlang.does_not_exist
+
+    def test_first_config_budget(self):
+        code = (
+            "import time, hyprlang_pybind as h\n"
+            "t = time.perf_counter()\n"
+            "c = h.Config('x = 1', is_stream=True)\n"
+            "c.add('x', 0)\n"
+            "c.commence()\n"
+            "c.parse()\n"
+            "print(time.perf_counter() - t)\n"
+        )
+        best = min(float(self.run(code)) for _ in range(5))
+        if os.environ.get("HYPRLANG_PYBIND_TIMING") == "1":
+            assert best < self.FIRST_CONFIG_BUDGET
+        else:
+            assert best < self.FIRST_CONFIG_BOUND
+
+
 class TestParseStringErrors:
     """Test that genuinely invalid syntax raises an error."""
 
@@ -2,7 +2,14 @@
 
 import os
 import pytest
-from hyprlang_pybind._core import Config, ConfigOptions, ParseResult, SVector2D
+from hyprlang_pybind._core import (
+    Config,
+    ConfigOptions,
+    LiveSnapshot,
+    OverlayBase,
+    ParseResult,
+    SVector2D,
+)
 
 FIXTURES = os.path.join(os.path.dirname(__file__), "fixtures")
 TEST_CONF = os.path.join(FIXTURES, "test.conf")
@@ -143,6 +150,39 @@ class TestConfigBasic:
         except RuntimeError:
             pass
 
+    def test_snapshot(self):
+        opts = ConfigOptions()
+        opts.path_is_stream = 1
+        config = Config("a = 3\nv = 1 2", opts)
+        config.add_value("a", 0)
+        config.add_value("v", SVector2D(0.0, 0.0))
+        config.commence()
+        config.parse()
+
+        snap = config.snapshot(["a", "v", "missing"])
+        assert len(snap) == 2
+        assert snap.keys() == ["a", "v"]
+        assert snap["a"] == 3
+        assert snap["v"] == (1.0, 2.0)
+        assert "missing" not in snap
+
+        everything = config.snapshot()
+        assert everything.keys() == ["a", "v"]
+        assert config.to_json() == config.to_json(["a", "v"]) == '{"a": 3, "v": [1.0, 2.0]}'
+
+    def test_source_cached_stream_root_path(self, tmp_path):
+        (tmp_path / "inc.conf").write_text("a = 3\n")
+        opts = ConfigOptions()
+        opts.path_is_stream = 1
+        config = Config("source = inc.conf\n", opts, source_cache=True)
+        config.add_value("a", 0)
+        config.commence()
+        config.change_root_path(str(tmp_path / "host.conf"))
+
+        result = config.parse()
+        assert not result.error, result.error_message
+        assert config.get_value("a") == 3
+
     def test_allow_missing_config(self):
         opts = ConfigOptions()
         opts.allow_missing_config = 1
@@ -153,5 +193,36 @@ class TestConfigBasic:
         assert not result.error
 
 
+class TestLiveSnapshot:
+    def make_snapshot(self, value):
+        opts = ConfigOptions()
+        opts.path_is_stream = 1
+        config = Config(f"a = {value}", opts)
+        config.add_value("a", 0)
+        config.commence()
+        config.parse()
+        return config.snapshot(["a"])
+
+    def test_rejects_none(self):
+        with pytest.raises(ValueError):
+            LiveSnapshot(None)
+        live = LiveSnapshot(self.make_snapshot(1))
+        with pytest.raises(ValueError):
+            live.publish(None)
+        assert live["a"] == 1
+        assert live.version == 1
+
+    def test_publish(self):
+        live = LiveSnapshot(self.make_snapshot(1))
+        assert live.publish(self.make_snapshot(2)) == 2
+        assert (live.version, live["a"]) == (2, 2)
+
+
+class TestOverlayBase:
+    def test_rejects_none(self):
+        with pytest.raises(ValueError):
+            OverlayBase(None)
+
+
 if __name__ == "__main__":
     pytest.main([__file__, "-v"])